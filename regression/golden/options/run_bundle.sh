@@ -0,0 +1,27 @@
+#!/bin/bash
+#
+# Runs the dictionaries of a bundle generated by OpenSMOKEpp_RespecthConverter
+# Usage: run_bundle.sh <index (1-2)>, or submitted as an array job
+# from the folder where the conversion was run
+#
+#SBATCH --array=1-2
+#PBS -J 1-2
+
+# Folder of the OpenSMOKE++ solvers (empty: solvers in the PATH)
+OPENSMOKEPP_BIN=${OPENSMOKEPP_BIN:-}
+
+index=${1:-${SLURM_ARRAY_TASK_ID:-${PBS_ARRAY_INDEX}}}
+if [ -z "$index" ]; then
+	echo "Usage: $0 <index (1-2)>"
+	exit 1
+fi
+
+cd "${PBS_O_WORKDIR:-.}" || exit 1
+
+status=0
+while read -r solver dictionary; do
+	case "$solver" in \#*|"") continue ;; esac
+	"${OPENSMOKEPP_BIN:+${OPENSMOKEPP_BIN}/}OpenSMOKEpp_${solver}.sh" --input "$dictionary" < /dev/null || status=1
+done < "output/bundle.${index}.txt"
+
+exit $status
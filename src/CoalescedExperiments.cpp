@@ -0,0 +1,100 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "CoalescedExperiments.h"
+#include "PerformanceStatistics.h"
+#include "TraceEvents.h"
+
+bool CoalescedExperiments::Add(std::unique_ptr<Respecth2OpenSMOKEpp>& experiment, const std::string& file_name)
+{
+	const std::string key = experiment->CoalescingKey();
+	if (key.empty() == true)
+		return false;
+
+	experiment->CompactXMLTree();
+
+	const auto it = groups_.insert(std::make_pair(key, static_cast<unsigned int>(experiments_.size())));
+	if (it.second == true)
+	{
+		experiments_.push_back(std::move(experiment));
+		keys_.push_back(key);
+		file_names_.push_back(file_name);
+		sizes_.push_back(1);
+	}
+	else
+	{
+		experiments_[it.first->second]->Coalesce(*experiment);
+		sizes_[it.first->second]++;
+		experiment.reset();
+	}
+
+	std::cout << " * Experiment kept for coalescing (written after the conversion of all the files)" << std::endl;
+	return true;
+}
+
+void CoalescedExperiments::WriteOnASCIIFiles()
+{
+	for (unsigned int k = 0; k < experiments_.size(); k++)
+	{
+		PerformanceStatistics::Instance().SetExperimentType(experiments_[k]->experiment_type());
+
+		if (sizes_[k] == 1)
+		{
+			TraceEvents::Instance().SetFileName(file_names_[k]);
+			std::cout << "Writing file: " << file_names_[k] << std::endl;
+			experiments_[k]->WriteOnASCIIFile(file_names_[k]);
+		}
+		else
+		{
+			// Named after the key, so that the name does not depend on the other groups (nor on the order of the files)
+			const std::string name = "coalesced." + ContentHash(keys_[k]);
+			TraceEvents::Instance().SetFileName(name + ".dic");
+			std::cout << "Writing file: " << name << ".dic (" << sizes_[k] << " experiments)" << std::endl;
+			experiments_[k]->WriteCoalescedOnASCIIFile(name);
+		}
+
+		experiments_[k].reset();
+	}
+
+	PerformanceStatistics::Instance().SetExperimentType("");
+
+	experiments_.clear();
+	groups_.clear();
+	keys_.clear();
+	file_names_.clear();
+	sizes_.clear();
+}
@@ -0,0 +1,70 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Respecth2OpenSMOKEpp.h"
+
+// Experiments of different files with the same coalescing key (same reactor, conditions
+// and composition, different temperatures) are written in a single dictionary, so that the
+// kinetic mechanism is loaded only once. Experiments are kept until all the files are
+// converted: the first one of each group absorbs the dataPoints of the following ones.
+// Memory grows with the number of coalescable experiments, since any later file may join a
+// group; their XML trees are reduced to the measured compositions to limit it.
+class CoalescedExperiments
+{
+public:
+
+	// Takes the experiment if it can be coalesced (returns false and leaves it untouched otherwise)
+	bool Add(std::unique_ptr<Respecth2OpenSMOKEpp>& experiment, const std::string& file_name);
+
+	// coalesced.<hash of the key>.dic for groups of experiments, the original name for experiments without partners
+	void WriteOnASCIIFiles();
+
+private:
+
+	std::map<std::string, unsigned int> groups_;
+	std::vector< std::unique_ptr<Respecth2OpenSMOKEpp> > experiments_;
+	std::vector<std::string> keys_;
+	std::vector<std::string> file_names_;
+	std::vector<unsigned int> sizes_;
+};
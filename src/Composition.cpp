@@ -36,8 +36,10 @@
 
 #include "Composition.h"
 #include "DatabaseSpecies.h"
+#include "PerformanceStatistics.h"
 #include <algorithm>
 #include <iterator>
+#include <cmath>
 
 void Composition::ImportFromXMLTree(boost::property_tree::ptree& ptree)
 {
@@ -63,8 +65,11 @@ void Composition::ImportFromXMLTree(boost::property_tree::ptree& ptree)
 
 void Composition::ImportFromXMLTree(boost::property_tree::ptree& ptree, const std::vector<std::string> species_in_kinetic_mech, const bool case_sensitive, DatabaseSpecies& database_species)
 {
+	ScopedStageTimer timer("species");
+
 	// Import species
 	ImportFromXMLTree(ptree);
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::SPECIES, names_key_.size());
 	
 	// Check for species in the database
 	CheckForSpeciesNames(database_species);
@@ -80,11 +85,14 @@ void Composition::Set(	const std::vector<std::string> names, const std::vector<d
 						const std::vector<std::string> names_chem, const std::vector<std::string> CAS,
 						const std::vector<std::string> species_in_kinetic_mech, const bool case_sensitive, DatabaseSpecies& database_species)
 {
+	ScopedStageTimer timer("species");
+
 	names_key_ = names;
 	composition_ = values;
 	units_ = units;
 	names_chem_ = names_chem;
 	names_CAS_ = CAS;
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::SPECIES, names_key_.size());
 
 	// Check for species in the database
 	CheckForSpeciesNames(database_species);
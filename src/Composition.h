@@ -62,6 +62,10 @@ public:
 
 	void WriteOnASCIIFile(std::ofstream& fOut) const;
 
+	const std::vector<std::string>& names() const { return names_key_; }
+
+	const std::vector<double>& values() const { return composition_; }
+
 private:
 
 	void ImportFromXMLTree(boost::property_tree::ptree& ptree);
@@ -35,6 +35,7 @@
 \*-----------------------------------------------------------------------*/
 
 #include "Conversions.h"
+#include "PerformanceStatistics.h"
 
 void CheckAndConvertUnits(const std::string name, double& value, std::string& units)
 {
@@ -145,8 +146,39 @@ void CheckAndConvertUnits(const std::string name, double& value, std::string& un
 
 void CheckAndConvertUnits(const std::string name, std::vector<double>& values, std::string& units)
 {
+	ScopedStageTimer timer("units");
+
+	// The units are converted together with the first value: all the values refer to the original ones
+	const std::string original_units = units;
 	for (unsigned int i = 0; i < values.size(); i++)
+	{
+		units = original_units;
 		CheckAndConvertUnits(name, values[i], units);
+	}
+}
+
+double ValueInSIUnits(const double value, const std::string& units)
+{
+	// Units as converted by CheckAndConvertUnits (empty: dimensionless)
+	if (units == "" || units == "K" || units == "Pa" || units == "s" || units == "m3" || units == "1/s" || units == "m" || units == "m/s" || units == "kg/m2/s")
+		return value;
+	else if (units == "atm")		return value * 101325.;
+	else if (units == "bar")		return value * 1.e5;
+	else if (units == "ms")			return value * 1.e-3;
+	else if (units == "min")		return value * 60.;
+	else if (units == "dm3")		return value * 1.e-3;
+	else if (units == "cm3")		return value * 1.e-6;
+	else if (units == "mm3")		return value * 1.e-9;
+	else if (units == "1/ms")		return value * 1.e3;
+	else if (units == "dm")			return value * 1.e-1;
+	else if (units == "cm")			return value * 1.e-2;
+	else if (units == "mm")			return value * 1.e-3;
+	else if (units == "cm/s")		return value * 1.e-2;
+	else if (units == "mm/s")		return value * 1.e-3;
+	else if (units == "g/cm2/s")	return value * 10.;
+
+	ConversionErrorMessage("No conversion to SI units available for: " + units);
+	return value;
 }
 
 void ConversionErrorMessage(const std::string message)
@@ -44,5 +44,9 @@ void CheckAndConvertUnits(const std::string name, double& value, std::string& un
 
 void CheckAndConvertUnits(const std::string name, std::vector<double>& values, std::string& units);
 
+// Value in SI units (K, Pa, s, m3, 1/s, m, m/s, kg/m2/s) of a value whose units were checked and converted
+// by CheckAndConvertUnits (fatal error for other units)
+double ValueInSIUnits(const double value, const std::string& units);
+
 void ConversionErrorMessage(const std::string message);
 
@@ -54,7 +54,22 @@ namespace OpenSMOKE
 			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@InputFolder",
 				OpenSMOKE::SINGLE_PATH,
 				"Name of the folder where the xml files are located",
-				true));
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@InputFileList",
+				OpenSMOKE::SINGLE_STRING,
+				"Name of the file containing the NUL-separated list of xml files to be converted (stdin: the list is read from the standard input). If specified, @InputFolder is not scanned",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@Streaming",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the subfolders of @InputFolder are scanned and the xml files are classified by a pool of tasks (at most one per hardware thread), while the files already classified are converted, in alphabetical order (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@CoalesceExperiments",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, temperature scans of ignition delays and jet stirred reactors from different files with the same reactor, pressure and composition are written in a single dictionary (coalesced.<hash>.dic, named after the common conditions), which maps its dataPoints back to the source files (default: false)",
+				false));
 
 			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@OutputFolderRemote",
 				OpenSMOKE::SINGLE_PATH,
@@ -75,6 +90,96 @@ namespace OpenSMOKE
 				OpenSMOKE::SINGLE_BOOL,
 				"If true, the names of species are treated as case sensitive (default: false)",
 				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@ProfileDecimationTolerance",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"Maximum interpolation error (relative to the range of values) allowed when V-t histories and temperature profiles are decimated (default: 0, i.e. no decimation)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@ShareProfiles",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, V-t histories are written only once in the profiles subfolder of @OutputFolderRemote, with names given by a hash of their content, and shared among dataPoints and files (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@EndTimePolicy",
+				OpenSMOKE::SINGLE_STRING,
+				"End time of ignition delay and jet stirred reactor simulations: global (from the largest measured delay or residence time) | buckets (one dictionary for each bucket of similar values) | per-point (one dictionary for each dataPoint) (default: global)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@EndTimeFactor",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"End time of ignition delay simulations as a multiple of the (largest) measured delay (default: 2)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@EndTimeBucketRatio",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"Maximum ratio between the measured delays (residence times) of dataPoints in the same bucket (default: 10)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@ResidenceTimeFactor",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"End time of jet stirred reactor simulations as a multiple of the (largest) residence time (default: 0, i.e. fixed end time equal to 5 s)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@MergeResidenceTimes",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, outlet concentration experiments are simulated with a single integration up to the largest residence time for each group of dataPoints with the same temperature and pressure, instead of one integration for each residence time. The output on file is written every few steps, so that a few outputs fall between the closest measured residence times. dataPoints whose temperature and pressure have a single residence time are kept together in a parametric analysis (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@SampleMeasuredTimes",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, concentration time profile experiments write the output on file every few integration steps, derived from the measured times so that a few outputs fall between the closest ones, instead of every step (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@RestrictOutputSpecies",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the solvers write on file only the species in the initial compositions, the measured species and the target of ignition delay measurements (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@ReorderPoints",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the cases of each dictionary are written along a nearest-neighbour path in the (normalized) space of temperature, pressure, and composition, so that consecutive cases are close to each other. The original indices of dataPoints are reported in the dictionary (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@SeedFlameSpeed",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the initial inlet velocity and the domain length of flame speed simulations are derived from the measured laminar burning velocity, with one dictionary for each bucket of similar velocities (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@FlameSpeedBucketRatio",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"Maximum ratio between the measured laminar burning velocities of dataPoints in the same bucket (default: 2)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@PlanFlameGrid",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the length and the number of (initial and maximum) points of the grid of burner stabilized flames are derived from the measured sampling positions (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@Fidelity",
+				OpenSMOKE::SINGLE_STRING,
+				"Preset of solver settings (ODE tolerances, output frequency except the outputs used to sample measured times, flame grids, ignition detection): screening | production | reference (default: production)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@AutomaticTolerances",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, the absolute tolerance of ODE solvers is chosen for each file from the smallest measured mole fraction (or the target amount of the ignition criterion). The choice is reported in the dictionary (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@MaxPointsPerDictionary",
+				OpenSMOKE::SINGLE_INT,
+				"Maximum number of dataPoints in a single dictionary: larger parametric analyses (or groups of dataPoints) are split in chunks of similar size, written in separate dictionaries with their own output folders (default: 0, i.e. no limit)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@DeduplicatePoints",
+				OpenSMOKE::SINGLE_BOOL,
+				"If true, dataPoints of ignition delays, jet stirred reactors, outlet concentrations and burning velocities with the same conditions (in SI units) as a dataPoint already converted are not simulated again: the reference table shared_points.txt in the output folder lists the simulated dataPoint of each of them (default: false)",
+				false));
+
+			AddKeyWord(OpenSMOKE::OpenSMOKE_DictionaryKeyWord("@DeduplicationTolerance",
+				OpenSMOKE::SINGLE_DOUBLE,
+				"Relative tolerance used to round temperature, pressure, composition, volume and residence time before comparing the dataPoints (default: 1e-4)",
+				false));
 		}
 	};
 }
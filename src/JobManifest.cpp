@@ -0,0 +1,272 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "JobManifest.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <algorithm>
+#include <map>
+
+JobManifest& JobManifest::Instance()
+{
+	static JobManifest instance;
+	return instance;
+}
+
+JobManifest::JobManifest() :
+	is_active_(false)
+{
+}
+
+void JobManifest::SetActive(const bool flag)
+{
+	is_active_ = flag;
+}
+
+void JobManifest::Add(const Job& job)
+{
+	if (is_active_ == false)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	jobs_.push_back(job);
+}
+
+void JobManifest::WriteOnFile(const boost::filesystem::path& file_name, const bool sort_by_cost) const
+{
+	const std::vector<Job> jobs = ListOfJobs(sort_by_cost);
+
+	double total = 0.;
+	for (unsigned int i = 0; i < jobs.size(); i++)
+		total += jobs[i].cost;
+
+	std::ofstream fOut(file_name.string(), std::ios::out);
+
+	fOut << "# Dictionaries: " << jobs.size() << std::endl;
+	fOut << "# Total cost:   " << std::scientific << std::setprecision(3) << total << std::endl;
+	fOut << "# Order:        " << ((sort_by_cost == true) ? "decreasing cost" : "conversion") << std::endl;
+	fOut << "#" << std::endl;
+	fOut << "# " << std::left << std::setw(9) << "cost" << std::setw(8) << "points" << std::setw(24) << "solver" << "dictionary (experiment type)" << std::endl;
+
+	for (unsigned int i = 0; i < jobs.size(); i++)
+	{
+		fOut << std::scientific << std::setprecision(3) << jobs[i].cost << "  ";
+		fOut << std::left << std::setw(7) << jobs[i].points << " ";
+		fOut << std::setw(23) << jobs[i].solver << " ";
+		fOut << jobs[i].dictionary << " (" << jobs[i].experiment_type << ")" << std::endl;
+	}
+
+	fOut.close();
+}
+
+std::vector<JobManifest::Job> JobManifest::ListOfJobs(const bool sort_by_cost) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// Longest first; dictionaries with the same cost keep the conversion order
+	std::vector<Job> jobs = jobs_;
+	if (sort_by_cost == true)
+		std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.cost > b.cost; });
+	return jobs;
+}
+
+void JobManifest::WriteBundles(const boost::filesystem::path& folder, const unsigned int n) const
+{
+	// Longest processing time first: every dictionary goes to the bundle with the lowest cost so far
+	const std::vector<Job> jobs = ListOfJobs(true);
+
+	std::vector< std::vector<unsigned int> > bundles(n);
+	std::vector<double> costs(n, 0.);
+	for (unsigned int i = 0; i < jobs.size(); i++)
+	{
+		const unsigned int k = static_cast<unsigned int>(std::distance(costs.begin(), std::min_element(costs.begin(), costs.end())));
+		bundles[k].push_back(i);
+		costs[k] += jobs[i].cost;
+	}
+
+	for (unsigned int k = 0; k < n; k++)
+	{
+		const boost::filesystem::path file_name = folder / ("bundle." + std::to_string(k + 1) + ".txt");
+		std::ofstream fOut(file_name.string(), std::ios::out);
+
+		fOut << "# Bundle " << k + 1 << "/" << n << ": " << bundles[k].size() << " dictionaries, estimated cost ";
+		fOut << std::scientific << std::setprecision(3) << costs[k] << std::endl;
+		for (unsigned int i = 0; i < bundles[k].size(); i++)
+			fOut << jobs[bundles[k][i]].solver << " " << jobs[bundles[k][i]].dictionary << std::endl;
+
+		fOut.close();
+	}
+
+	// Launcher: the names of the dictionaries are relative to the folder where the conversion was run
+	{
+		const boost::filesystem::path file_name = folder / "run_bundle.sh";
+		std::ofstream fOut(file_name.string(), std::ios::out);
+
+		const std::string range = "1-" + std::to_string(n);
+		fOut << "#!/bin/bash" << std::endl;
+		fOut << "#" << std::endl;
+		fOut << "# Runs the dictionaries of a bundle generated by OpenSMOKEpp_RespecthConverter" << std::endl;
+		fOut << "# Usage: run_bundle.sh <index (" << range << ")>, or submitted as an array job" << std::endl;
+		fOut << "# from the folder where the conversion was run" << std::endl;
+		fOut << "#" << std::endl;
+		fOut << "#SBATCH --array=" << range << std::endl;
+		fOut << "#PBS -J " << range << std::endl;
+		fOut << std::endl;
+		fOut << "# Folder of the OpenSMOKE++ solvers (empty: solvers in the PATH)" << std::endl;
+		fOut << "OPENSMOKEPP_BIN=${OPENSMOKEPP_BIN:-}" << std::endl;
+		fOut << std::endl;
+		fOut << "index=${1:-${SLURM_ARRAY_TASK_ID:-${PBS_ARRAY_INDEX}}}" << std::endl;
+		fOut << "if [ -z \"$index\" ]; then" << std::endl;
+		fOut << "\techo \"Usage: $0 <index (" << range << ")>\"" << std::endl;
+		fOut << "\texit 1" << std::endl;
+		fOut << "fi" << std::endl;
+		fOut << std::endl;
+		fOut << "cd \"${PBS_O_WORKDIR:-.}\" || exit 1" << std::endl;
+		fOut << std::endl;
+		fOut << "status=0" << std::endl;
+		fOut << "while read -r solver dictionary; do" << std::endl;
+		fOut << "\tcase \"$solver\" in \\#*|\"\") continue ;; esac" << std::endl;
+		fOut << "\t\"${OPENSMOKEPP_BIN:+${OPENSMOKEPP_BIN}/}OpenSMOKEpp_${solver}.sh\" --input \"$dictionary\" < /dev/null || status=1" << std::endl;
+		fOut << "done < \"" << (folder / "bundle.").generic_string() << "${index}.txt\"" << std::endl;
+		fOut << std::endl;
+		fOut << "exit $status" << std::endl;
+
+		fOut.close();
+
+		boost::filesystem::permissions(file_name, boost::filesystem::add_perms | boost::filesystem::owner_exe | boost::filesystem::group_exe | boost::filesystem::others_exe);
+	}
+
+	// Balance of the bundles
+	const double max = (n != 0) ? *std::max_element(costs.begin(), costs.end()) : 0.;
+	double total = 0.;
+	for (unsigned int k = 0; k < n; k++)
+		total += costs[k];
+
+	std::ostringstream balance;
+	balance << std::fixed << std::setprecision(2) << ((total > 0.) ? max * n / total : 1.);
+	std::cout << "Bundles: " << n << " for " << jobs.size() << " dictionaries (largest/average estimated cost: " << balance.str() << ")" << std::endl;
+}
+
+static std::string NinjaPath(const std::string& path)
+{
+	std::string escaped;
+	for (std::size_t i = 0; i < path.size(); i++)
+	{
+		if (path[i] == '$' || path[i] == ' ' || path[i] == ':')
+			escaped += '$';
+		escaped += path[i];
+	}
+	return escaped;
+}
+
+// Single-quoted for the shell, so that any file name reaches the solver unchanged
+static std::string ShellQuote(const std::string& path)
+{
+	std::string quoted = "'";
+	for (std::size_t i = 0; i < path.size(); i++)
+	{
+		if (path[i] == '\'')
+			quoted += "'\\''";
+		else
+			quoted += path[i];
+	}
+	return quoted + "'";
+}
+
+void JobManifest::WriteNinjaFile(const boost::filesystem::path& folder, const unsigned int pool_depth) const
+{
+	// Conversion order: ninja schedules the targets by itself
+	const std::vector<Job> jobs = ListOfJobs(false);
+
+	const boost::filesystem::path file_name = folder / "build.ninja";
+	std::ofstream fOut(file_name.string(), std::ios::out);
+
+	fOut << "# Simulations generated by OpenSMOKEpp_RespecthConverter" << std::endl;
+	fOut << "# Usage: ninja -f " << file_name.generic_string() << ", from the folder where the conversion was run" << std::endl;
+	fOut << "# Every simulation is run again only if its dictionary, its profiles or the kinetic mechanism changed." << std::endl;
+	fOut << "# Folder of the OpenSMOKE++ solvers: $OPENSMOKEPP_BIN (empty: solvers in the PATH)" << std::endl;
+	fOut << std::endl;
+	fOut << "ninja_required_version = 1.3" << std::endl;
+	fOut << "builddir = " << NinjaPath(folder.generic_string()) << std::endl;
+	fOut << std::endl;
+	fOut << "pool solvers" << std::endl;
+	fOut << "  depth = " << pool_depth << std::endl;
+	fOut << std::endl;
+	fOut << "rule simulate" << std::endl;
+	fOut << "  command = \"$${OPENSMOKEPP_BIN:+$${OPENSMOKEPP_BIN}/}OpenSMOKEpp_$solver.sh\" --input $dictionary < /dev/null > $log 2>&1 && touch $stamp" << std::endl;
+	fOut << "  description = $solver $in" << std::endl;
+	fOut << "  pool = solvers" << std::endl;
+
+	// xml files with the same name in different folders are converted to the same dictionary: the last
+	// conversion is the one on disk, and ninja accepts a single edge per output
+	std::map<std::string, unsigned int> last_job;
+	for (unsigned int i = 0; i < jobs.size(); i++)
+		last_job[jobs[i].dictionary] = i;
+
+	for (unsigned int i = 0; i < jobs.size(); i++)
+	{
+		if (last_job[jobs[i].dictionary] != i)
+			continue;
+
+		// The stamp is written next to the dictionary only if the solver succeeded
+		const boost::filesystem::path dictionary(jobs[i].dictionary);
+		const boost::filesystem::path log = boost::filesystem::path(dictionary).replace_extension(".log");
+		const boost::filesystem::path stamp = boost::filesystem::path(dictionary).replace_extension(".stamp");
+
+		fOut << std::endl;
+		fOut << "build " << NinjaPath(stamp.generic_string()) << ": simulate " << NinjaPath(dictionary.generic_string());
+		if (jobs[i].inputs.size() != 0)
+		{
+			fOut << " |";
+			for (unsigned int j = 0; j < jobs[i].inputs.size(); j++)
+				fOut << " " << NinjaPath(boost::filesystem::path(jobs[i].inputs[j]).generic_string());
+		}
+		fOut << std::endl;
+		fOut << "  solver = " << jobs[i].solver << std::endl;
+		fOut << "  dictionary = " << NinjaPath(ShellQuote(dictionary.generic_string())) << std::endl;
+		fOut << "  log = " << NinjaPath(ShellQuote(log.generic_string())) << std::endl;
+		fOut << "  stamp = " << NinjaPath(ShellQuote(stamp.generic_string())) << std::endl;
+	}
+
+	if (last_job.size() != jobs.size())
+		std::cout << "Ninja: " << jobs.size() - last_job.size() << " dictionaries overwritten by xml files with the same name in other folders" << std::endl;
+
+	fOut.close();
+}
@@ -0,0 +1,92 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <boost/filesystem.hpp>
+
+// List of the generated dictionaries with the estimated cost of their simulations, so that
+// batch runners can start the most expensive ones first (longest-processing-time scheduling).
+// The cost is in arbitrary units: only the ratios between dictionaries are meaningful.
+// The dictionaries can also be packed in bundles of similar cost, to be run as array jobs, or
+// listed in a build.ninja file, so that only the simulations whose inputs changed are run again.
+class JobManifest
+{
+public:
+
+	struct Job
+	{
+		std::string dictionary;
+		std::string experiment_type;
+		std::string solver;
+		std::string output_folder;					// written by the solver
+		std::vector<std::string> inputs;			// read by the solver (kinetic mechanism, profiles)
+		std::size_t points;
+		double cost;
+	};
+
+	static JobManifest& Instance();
+
+	void SetActive(const bool flag);
+
+	bool is_active() const { return is_active_; }
+
+	void Add(const Job& job);
+
+	void WriteOnFile(const boost::filesystem::path& file_name, const bool sort_by_cost) const;
+
+	// bundle.<k>.txt (k = 1...n) and the launcher run_bundle.sh in the given folder
+	void WriteBundles(const boost::filesystem::path& folder, const unsigned int n) const;
+
+	// build.ninja in the given folder, with at most pool_depth solvers running at the same time
+	void WriteNinjaFile(const boost::filesystem::path& folder, const unsigned int pool_depth) const;
+
+private:
+
+	JobManifest();
+
+	std::vector<Job> ListOfJobs(const bool sort_by_cost) const;
+
+	std::atomic<bool> is_active_;
+
+	std::vector<Job> jobs_;
+	mutable std::mutex mutex_;
+};
@@ -0,0 +1,298 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "MemoryStatistics.h"
+#include <new>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace
+{
+	std::atomic<std::size_t> live_bytes_(0);
+
+	// Net bytes allocated by each thread (blocks can be freed by another thread) and their peak
+	thread_local std::size_t thread_allocations_ = 0;
+	thread_local std::ptrdiff_t thread_live_bytes_ = 0;
+	thread_local std::ptrdiff_t thread_peak_bytes_ = 0;
+
+	std::size_t ReadFromProcStatus(const std::string& key)
+	{
+		std::ifstream fInput("/proc/self/status", std::ios::in);
+
+		std::string line;
+		while (std::getline(fInput, line))
+		{
+			if (line.compare(0, key.size(), key) == 0)
+			{
+				std::istringstream stream(line.substr(key.size() + 1));
+				std::size_t kB = 0;
+				stream >> kB;
+				return kB * 1024;
+			}
+		}
+
+		return 0;
+	}
+
+	std::string FormatMB(const std::size_t bytes)
+	{
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(2) << bytes / 1024. / 1024.;
+		return stream.str();
+	}
+}
+
+#if defined(RESPECTHCONVERTER_COUNT_ALLOCATIONS)
+
+// The size of each block is stored in front of it, so that live bytes can be tracked also
+// by the unsized operator delete
+namespace
+{
+	const std::size_t header_size_ = 16;
+
+	void* CountedAllocation(std::size_t size)
+	{
+		void* p = std::malloc(size + header_size_);
+		if (p == nullptr)
+			return nullptr;
+
+		*static_cast<std::size_t*>(p) = size;
+		live_bytes_ += size;
+		thread_allocations_++;
+		thread_live_bytes_ += static_cast<std::ptrdiff_t>(size);
+		thread_peak_bytes_ = std::max(thread_peak_bytes_, thread_live_bytes_);
+
+		return static_cast<char*>(p) + header_size_;
+	}
+
+	void CountedDeallocation(void* p)
+	{
+		if (p == nullptr)
+			return;
+
+		void* block = static_cast<char*>(p) - header_size_;
+		live_bytes_ -= *static_cast<std::size_t*>(block);
+		thread_live_bytes_ -= static_cast<std::ptrdiff_t>(*static_cast<std::size_t*>(block));
+		std::free(block);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	void* p = CountedAllocation(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	void* p = CountedAllocation(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocation(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocation(size); }
+void operator delete(void* p) noexcept { CountedDeallocation(p); }
+void operator delete[](void* p) noexcept { CountedDeallocation(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedDeallocation(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedDeallocation(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedDeallocation(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedDeallocation(p); }
+
+bool MemoryStatistics::is_counting_allocations() { return true; }
+
+#else
+
+bool MemoryStatistics::is_counting_allocations() { return false; }
+
+#endif
+
+MemoryStatistics& MemoryStatistics::Instance()
+{
+	static MemoryStatistics instance;
+	return instance;
+}
+
+thread_local MemoryStatistics::FileData MemoryStatistics::current_file_;
+thread_local MemoryStatistics::Mark MemoryStatistics::file_mark_;
+
+std::size_t MemoryStatistics::allocations()
+{
+	return thread_allocations_;
+}
+
+std::size_t MemoryStatistics::live_bytes()
+{
+	return live_bytes_;
+}
+
+std::size_t MemoryStatistics::ResidentSetSize()
+{
+	return ReadFromProcStatus("VmRSS");
+}
+
+std::size_t MemoryStatistics::PeakResidentSetSize()
+{
+	return ReadFromProcStatus("VmHWM");
+}
+
+void MemoryStatistics::ResetPeakResidentSetSize()
+{
+	// Supported by Linux kernels >= 4.0, silently ignored elsewhere
+	std::ofstream fOut("/proc/self/clear_refs", std::ios::out);
+	if (fOut.is_open())
+		fOut << "5";
+}
+
+// Peaks of nested stages are measured by resetting the peak of the thread at the beginning
+// of each stage and restoring the peak of the enclosing stage at its end
+MemoryStatistics::Mark MemoryStatistics::BeginStage()
+{
+	Mark mark;
+	mark.allocations = thread_allocations_;
+	mark.thread_live_bytes = thread_live_bytes_;
+	mark.thread_peak_outer = thread_peak_bytes_;
+	mark.live_bytes = live_bytes_;
+
+	thread_peak_bytes_ = thread_live_bytes_;
+	return mark;
+}
+
+std::size_t MemoryStatistics::EndOfMark(const Mark& mark, std::size_t& allocations)
+{
+	const std::ptrdiff_t growth = thread_peak_bytes_ - mark.thread_live_bytes;
+	thread_peak_bytes_ = std::max(mark.thread_peak_outer, thread_peak_bytes_);
+
+	allocations = thread_allocations_ - mark.allocations;
+	return mark.live_bytes + static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, growth));
+}
+
+void MemoryStatistics::EndStage(const char* stage, const Mark& mark)
+{
+	std::size_t allocations = 0;
+	const std::size_t peak_stage = EndOfMark(mark, allocations);
+
+	// Reading /proc/self/status costs more than most stages
+	const std::size_t rss = (is_stage_sampling_ == true) ? ResidentSetSize() : 0;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	StageData& data = stages_[stage];
+	data.calls++;
+	data.allocations += allocations;
+	data.peak_bytes = std::max(data.peak_bytes, peak_stage);
+	data.max_rss = std::max(data.max_rss, rss);
+}
+
+// The peak RSS is a property of the process: with concurrent tasks (streaming mode), it includes their memory
+void MemoryStatistics::BeginFile(const std::string& file_name)
+{
+	if (is_active_ == false)
+		return;
+
+	ResetPeakResidentSetSize();
+
+	current_file_ = FileData();
+	current_file_.name = file_name;
+	file_mark_ = BeginStage();
+}
+
+void MemoryStatistics::EndFile()
+{
+	if (is_active_ == false)
+		return;
+
+	current_file_.peak_bytes = EndOfMark(file_mark_, current_file_.allocations);
+	current_file_.peak_rss = PeakResidentSetSize();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	files_.push_back(current_file_);
+}
+
+void MemoryStatistics::Summary(std::ostream& out, const unsigned int n_worst) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const bool counting = is_counting_allocations();
+
+	out << std::endl;
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+	out << " Memory statistics (current RSS: " << FormatMB(ResidentSetSize()) << " MB, peak RSS: " << FormatMB(PeakResidentSetSize()) << " MB)" << std::endl;
+	if (counting == false)
+		out << " Allocations are not counted: compile with RESPECTHCONVERTER_COUNT_ALLOCATIONS" << std::endl;
+	if (is_stage_sampling_ == false)
+		out << " RSS is sampled once per file: use --memory-stages for the RSS at the end of each stage" << std::endl;
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+
+	out << std::left << std::setw(28) << "  Stage" << std::right << std::setw(12) << "Calls";
+	out << std::setw(16) << "Allocations" << std::setw(16) << "PeakHeap[MB]" << std::setw(14) << "MaxRSS[MB]" << std::endl;
+	for (std::map<std::string, StageData>::const_iterator it = stages_.begin(); it != stages_.end(); ++it)
+	{
+		out << std::left << std::setw(28) << ("  " + it->first) << std::right;
+		out << std::setw(12) << it->second.calls;
+		out << std::setw(16) << (counting ? std::to_string(it->second.allocations) : "n.a.");
+		out << std::setw(16) << (counting ? FormatMB(it->second.peak_bytes) : "n.a.");
+		out << std::setw(14) << (is_stage_sampling_ ? FormatMB(it->second.max_rss) : "n.a.");
+		out << std::endl;
+	}
+
+	// Worst offenders, sorted by peak RSS (or by peak heap, if available)
+	std::vector<FileData> files = files_;
+	std::sort(files.begin(), files.end(), [counting](const FileData& a, const FileData& b)
+		{ return counting ? (a.peak_bytes > b.peak_bytes) : (a.peak_rss > b.peak_rss); });
+	files.resize(std::min<std::size_t>(files.size(), n_worst));
+
+	out << std::endl;
+	out << " Files with the largest memory usage" << std::endl;
+	out << std::right << std::setw(14) << "PeakRSS[MB]" << std::setw(16) << "PeakHeap[MB]" << std::setw(16) << "Allocations" << "  File" << std::endl;
+	for (unsigned int i = 0; i < files.size(); i++)
+	{
+		out << std::setw(14) << FormatMB(files[i].peak_rss);
+		out << std::setw(16) << (counting ? FormatMB(files[i].peak_bytes) : "n.a.");
+		out << std::setw(16) << (counting ? std::to_string(files[i].allocations) : "n.a.");
+		out << "  " << files[i].name << std::endl;
+	}
+
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+	out << std::endl;
+}
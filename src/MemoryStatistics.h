@@ -0,0 +1,132 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <iostream>
+
+// Memory usage of the conversion, per file and per stage. The resident set size is sampled
+// from /proc/self/status (Linux only), once per file unless the sampling at the end of every
+// stage is enabled (SetStageSampling). Allocation counts and live heap bytes are available
+// only if the executable is compiled with RESPECTHCONVERTER_COUNT_ALLOCATIONS, which replaces
+// the global operator new/delete with counting versions. Allocations and heap peaks of stages and
+// files are counted by the thread running them, so that concurrent tasks do not interfere: a peak is
+// the live heap of the process at the beginning plus the largest growth due to the thread.
+class MemoryStatistics
+{
+public:
+
+	static MemoryStatistics& Instance();
+
+	void SetActive(const bool flag) { is_active_ = flag; }
+
+	bool is_active() const { return is_active_; }
+
+	void SetStageSampling(const bool flag) { is_stage_sampling_ = flag; }
+
+	static bool is_counting_allocations();
+
+	// Allocations of the calling thread, live heap bytes of the process
+	static std::size_t allocations();
+
+	static std::size_t live_bytes();
+
+	// State of the calling thread at the beginning of a stage (or file)
+	struct Mark
+	{
+		std::size_t allocations = 0;
+		std::ptrdiff_t thread_live_bytes = 0;
+		std::ptrdiff_t thread_peak_outer = 0;
+		std::size_t live_bytes = 0;
+	};
+
+	static std::size_t ResidentSetSize();
+
+	static std::size_t PeakResidentSetSize();
+
+	static void ResetPeakResidentSetSize();
+
+	Mark BeginStage();
+
+	void EndStage(const char* stage, const Mark& mark);
+
+	void BeginFile(const std::string& file_name);
+
+	void EndFile();
+
+	void Summary(std::ostream& out, const unsigned int n_worst = 10) const;
+
+private:
+
+	MemoryStatistics() : is_active_(false), is_stage_sampling_(false) {};
+
+	struct StageData
+	{
+		std::size_t calls = 0;
+		std::size_t allocations = 0;
+		std::size_t peak_bytes = 0;
+		std::size_t max_rss = 0;
+	};
+
+	struct FileData
+	{
+		std::string name;
+		std::size_t peak_rss = 0;
+		std::size_t peak_bytes = 0;
+		std::size_t allocations = 0;
+	};
+
+	std::atomic<bool> is_active_;
+	std::atomic<bool> is_stage_sampling_;
+
+	std::map<std::string, StageData> stages_;
+	std::vector<FileData> files_;
+
+	static std::size_t EndOfMark(const Mark& mark, std::size_t& allocations);
+
+	// File being converted by each thread
+	static thread_local FileData current_file_;
+	static thread_local Mark file_mark_;
+
+	mutable std::mutex mutex_;
+};
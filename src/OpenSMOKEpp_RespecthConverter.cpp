@@ -47,6 +47,109 @@
 #include "Respecth2OpenSMOKEpp_ConcentrationTimeProfile.h"
 #include "Respecth2OpenSMOKEpp_OutletConcentration.h"
 #include "Respecth2OpenSMOKEpp_IgnitionDelay.h"
+#include "CoalescedExperiments.h"
+
+// Statistics
+#include "PerformanceStatistics.h"
+#include "TraceEvents.h"
+#include "MemoryStatistics.h"
+#include "JobManifest.h"
+#include "SharedPoints.h"
+
+// Standard library
+#include <deque>
+#include <future>
+#include <memory>
+#include <algorithm>
+#include <thread>
+
+void ConvertRespecthFile(	const boost::filesystem::path& xml_file,
+							const std::string& apparatus_kind,
+							const std::string& experiment_type,
+							const boost::filesystem::path& kinetics_folder,
+							const boost::filesystem::path& output_folder,
+							const std::vector<std::string>& species_in_kinetic_mech,
+							const bool case_sensitive,
+							DatabaseSpecies& database_species,
+							const ConversionSettings& settings,
+							CoalescedExperiments* coalesced_experiments)
+{
+	PerformanceStatistics::Instance().SetExperimentType(experiment_type);
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::FILES, 1);
+	TraceEvents::Instance().SetFileName(xml_file.filename().string());
+	MemoryStatistics::Instance().BeginFile(xml_file.string());
+
+	// The file stage is closed before the experiment type is reset, so that it is recorded under the experiment type
+	{
+		ScopedStageTimer timer("file");
+
+		std::cout << "Converting file: " << xml_file.filename().string() << std::endl;
+		std::cout << apparatus_kind << " " << experiment_type << std::endl;
+
+		std::unique_ptr<Respecth2OpenSMOKEpp> reactor;
+		{
+			ScopedStageTimer timer("constructor");
+
+			if (experiment_type == "jet stirred reactor measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_JetStirredReactor(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else if (experiment_type == "laminar burning velocity measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_LaminarBurningVelocity(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else if (experiment_type == "burner stabilized flame speciation measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else if (experiment_type == "concentration time profile measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_ConcentrationTimeProfile(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else if (experiment_type == "outlet concentration measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_OutletConcentration(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else if (experiment_type == "ignition delay measurement")
+				reactor.reset(new Respecth2OpenSMOKEpp_IgnitionDelay(xml_file, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings));
+
+			else
+				OpenSMOKE::FatalErrorMessage("Unknown experiment type: " + experiment_type);
+		}
+
+		if (coalesced_experiments == nullptr || coalesced_experiments->Add(reactor, xml_file.filename().string() + ".dic") == false)
+			reactor->WriteOnASCIIFile(xml_file.filename().string() + ".dic");
+		reactor.reset();
+	}
+
+	MemoryStatistics::Instance().EndFile();
+	PerformanceStatistics::Instance().SetExperimentType("");
+}
+
+// Files of a task of the streaming mode (subfolders are scanned recursively), with their classification
+struct ClassifiedFiles
+{
+	std::vector<boost::filesystem::path> files;
+	std::vector<std::string> apparatus_kinds;
+	std::vector<std::string> experiment_types;
+};
+
+ClassifiedFiles ClassifyFiles(const std::vector<boost::filesystem::path>& entries)
+{
+	ClassifiedFiles classified;
+	for (unsigned int k = 0; k < entries.size(); k++)
+	{
+		if (boost::filesystem::is_directory(entries[k]) == true)
+		{
+			const std::vector<boost::filesystem::path> list_xml_files = ListOfXMLFiles(entries[k]);
+			classified.files.insert(classified.files.end(), list_xml_files.begin(), list_xml_files.end());
+		}
+		else
+			classified.files.push_back(entries[k]);
+	}
+
+	classified.apparatus_kinds.resize(classified.files.size());
+	classified.experiment_types.resize(classified.files.size());
+	for (unsigned int j = 0; j < classified.files.size(); j++)
+		ReadExperimentTypeFromXML(classified.files[j], classified.apparatus_kinds[j], classified.experiment_types[j]);
+
+	return classified;
+}
 
 int main(int argc, char** argv)
 {
@@ -58,6 +161,15 @@ int main(int argc, char** argv)
 	std::string input_file_name_ = "input.dic";
 	std::string main_dictionary_name_ = "RespecthConverter";
 	unsigned int number_threads = 1;
+	bool print_statistics = false;
+	boost::filesystem::path trace_file_name;
+	bool print_memory_statistics = false;
+	bool sample_stage_memory = false;
+	boost::filesystem::path statistics_file_name;
+	boost::filesystem::path manifest_file_name;
+	bool sort_by_cost = false;
+	unsigned int number_of_bundles = 0;
+	unsigned int ninja_pool_depth = 0;
 
 	// Program options from command line
 	{
@@ -66,7 +178,16 @@ int main(int argc, char** argv)
 		description.add_options()
 			("help", "print help messages")
 			("input", po::value<std::string>(), "name of the file containing the main dictionary (default \"input.dic\")")
-			("dictionary", po::value<std::string>(), "name of the main dictionary to be used (default \"RespecthConverter\")");
+			("dictionary", po::value<std::string>(), "name of the main dictionary to be used (default \"RespecthConverter\")")
+			("stats", "print the time spent in each conversion stage and the throughput for each experiment type")
+			("stats-json", po::value<std::string>(), "name of the JSON file where the statistics are written (implies --stats)")
+			("trace", po::value<std::string>(), "name of the JSON file where the begin/end events of each file and stage are written (Chrome trace-event format)")
+			("memory", "print peak RSS, heap usage and allocations for each stage and the files with the largest memory usage")
+			("memory-stages", "as --memory, sampling the RSS also at the end of each stage (slower)")
+			("manifest", po::value<std::string>(), "name of the file where the generated dictionaries are listed together with their estimated cost and number of dataPoints")
+			("sort-by-cost", "list the dictionaries in the manifest by decreasing estimated cost (requires --manifest)")
+			("bundles", po::value<unsigned int>(), "number of bundles of similar estimated cost (one for each array job) written in the output folder together with the launcher run_bundle.sh")
+			("ninja", po::value<unsigned int>(), "maximum number of solvers running at the same time in the build.ninja file written in the output folder (0: number of hardware threads)");
 
 		po::variables_map vm;
 		try
@@ -86,6 +207,51 @@ int main(int argc, char** argv)
 			if (vm.count("dictionary"))
 				main_dictionary_name_ = vm["dictionary"].as<std::string>();
 
+			if (vm.count("stats"))
+				print_statistics = true;
+
+			if (vm.count("stats-json"))
+			{
+				print_statistics = true;
+				statistics_file_name = vm["stats-json"].as<std::string>();
+			}
+
+			if (vm.count("trace"))
+				trace_file_name = vm["trace"].as<std::string>();
+
+			if (vm.count("memory"))
+				print_memory_statistics = true;
+
+			if (vm.count("memory-stages"))
+			{
+				print_memory_statistics = true;
+				sample_stage_memory = true;
+			}
+
+			if (vm.count("manifest"))
+				manifest_file_name = vm["manifest"].as<std::string>();
+
+			if (vm.count("sort-by-cost"))
+			{
+				if (vm.count("manifest") == 0)
+					throw po::error("--sort-by-cost requires --manifest");
+				sort_by_cost = true;
+			}
+
+			if (vm.count("bundles"))
+			{
+				number_of_bundles = vm["bundles"].as<unsigned int>();
+				if (number_of_bundles == 0)
+					throw po::error("--bundles must be larger than 0");
+			}
+
+			if (vm.count("ninja"))
+			{
+				ninja_pool_depth = vm["ninja"].as<unsigned int>();
+				if (ninja_pool_depth == 0)
+					ninja_pool_depth = std::max(1U, std::thread::hardware_concurrency());
+			}
+
 			po::notify(vm); // throws on error, so do after help in case  there are any problems 
 		}
 		catch (po::error& e)
@@ -96,6 +262,20 @@ int main(int argc, char** argv)
 		}
 	}
 
+	// Statistics
+	PerformanceStatistics::Instance().SetActive(print_statistics);
+
+	// Trace events (written at the end of the conversion)
+	if (trace_file_name.empty() == false)
+		TraceEvents::Instance().Open(trace_file_name);
+
+	// Memory statistics
+	MemoryStatistics::Instance().SetActive(print_memory_statistics);
+	MemoryStatistics::Instance().SetStageSampling(sample_stage_memory);
+
+	// Manifest of the generated dictionaries
+	JobManifest::Instance().SetActive(manifest_file_name.empty() == false || number_of_bundles != 0 || ninja_pool_depth != 0);
+
 	// Defines the grammar rules
 	OpenSMOKE::Grammar_RespecthConverter grammar_respecthconverter;
 
@@ -153,9 +333,135 @@ int main(int argc, char** argv)
 		database_species.SetFromXML(path_database_species);
 	}
 
+	// Conversion settings
+	ConversionSettings settings;
+	if (dictionaries(main_dictionary_name_).CheckOption("@ProfileDecimationTolerance") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@ProfileDecimationTolerance", settings.profile_decimation_tolerance_);
+		if (settings.profile_decimation_tolerance_ < 0.)
+			OpenSMOKE::FatalErrorMessage("@ProfileDecimationTolerance must be non-negative");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@ShareProfiles") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@ShareProfiles", settings.share_profiles_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@EndTimePolicy") == true)
+	{
+		std::string policy;
+		dictionaries(main_dictionary_name_).ReadString("@EndTimePolicy", policy);
+		if (policy == "global")			settings.end_time_policy_ = ConversionSettings::EndTimePolicy::GLOBAL;
+		else if (policy == "buckets")	settings.end_time_policy_ = ConversionSettings::EndTimePolicy::BUCKETS;
+		else if (policy == "per-point")	settings.end_time_policy_ = ConversionSettings::EndTimePolicy::PER_POINT;
+		else OpenSMOKE::FatalErrorMessage("Unknown @EndTimePolicy: " + policy + ". Available: global | buckets | per-point");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@EndTimeFactor") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@EndTimeFactor", settings.end_time_factor_);
+		if (settings.end_time_factor_ <= 0.)
+			OpenSMOKE::FatalErrorMessage("@EndTimeFactor must be positive");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@EndTimeBucketRatio") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@EndTimeBucketRatio", settings.end_time_bucket_ratio_);
+		if (settings.end_time_bucket_ratio_ < 1.)
+			OpenSMOKE::FatalErrorMessage("@EndTimeBucketRatio must be larger than or equal to 1");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@ResidenceTimeFactor") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@ResidenceTimeFactor", settings.residence_time_factor_);
+		if (settings.residence_time_factor_ < 0.)
+			OpenSMOKE::FatalErrorMessage("@ResidenceTimeFactor must be larger than or equal to 0");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@MergeResidenceTimes") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@MergeResidenceTimes", settings.merge_residence_times_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@SampleMeasuredTimes") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@SampleMeasuredTimes", settings.sample_measured_times_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@RestrictOutputSpecies") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@RestrictOutputSpecies", settings.restrict_output_species_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@ReorderPoints") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@ReorderPoints", settings.reorder_points_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@SeedFlameSpeed") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@SeedFlameSpeed", settings.seed_flame_speed_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@FlameSpeedBucketRatio") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@FlameSpeedBucketRatio", settings.flame_speed_bucket_ratio_);
+		if (settings.flame_speed_bucket_ratio_ < 1.)
+			OpenSMOKE::FatalErrorMessage("@FlameSpeedBucketRatio must be larger than or equal to 1");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@PlanFlameGrid") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@PlanFlameGrid", settings.plan_flame_grid_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@Fidelity") == true)
+	{
+		std::string fidelity;
+		dictionaries(main_dictionary_name_).ReadString("@Fidelity", fidelity);
+		if (fidelity == "screening")		settings.fidelity_ = ConversionSettings::Fidelity::SCREENING;
+		else if (fidelity == "production")	settings.fidelity_ = ConversionSettings::Fidelity::PRODUCTION;
+		else if (fidelity == "reference")	settings.fidelity_ = ConversionSettings::Fidelity::REFERENCE;
+		else OpenSMOKE::FatalErrorMessage("Unknown @Fidelity: " + fidelity + ". Available: screening | production | reference");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@AutomaticTolerances") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@AutomaticTolerances", settings.automatic_tolerances_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@MaxPointsPerDictionary") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadInt("@MaxPointsPerDictionary", settings.max_points_per_dictionary_);
+		if (settings.max_points_per_dictionary_ < 0)
+			OpenSMOKE::FatalErrorMessage("@MaxPointsPerDictionary must be larger than or equal to 0");
+	}
+	if (dictionaries(main_dictionary_name_).CheckOption("@DeduplicatePoints") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@DeduplicatePoints", settings.deduplicate_points_);
+	if (dictionaries(main_dictionary_name_).CheckOption("@DeduplicationTolerance") == true)
+	{
+		dictionaries(main_dictionary_name_).ReadDouble("@DeduplicationTolerance", settings.deduplication_tolerance_);
+		if (settings.deduplication_tolerance_ <= 0. || settings.deduplication_tolerance_ >= 1.)
+			OpenSMOKE::FatalErrorMessage("@DeduplicationTolerance must be larger than 0 and smaller than 1");
+	}
+
+	// Streaming mode
+	bool streaming = false;
+	if (dictionaries(main_dictionary_name_).CheckOption("@Streaming") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@Streaming", streaming);
+
+	// Coalescing of compatible experiments of different files
+	bool coalesce_experiments = false;
+	if (dictionaries(main_dictionary_name_).CheckOption("@CoalesceExperiments") == true)
+		dictionaries(main_dictionary_name_).ReadBool("@CoalesceExperiments", coalesce_experiments);
+
+	CoalescedExperiments coalesced;
+	CoalescedExperiments* coalesced_experiments = (coalesce_experiments == true) ? &coalesced : nullptr;
+
+	// List of files provided explicitly: no need to scan the input folder
+	if (dictionaries(main_dictionary_name_).CheckOption("@InputFileList") == true)
+	{
+		std::string input_file_list;
+		dictionaries(main_dictionary_name_).ReadString("@InputFileList", input_file_list);
+
+		std::vector<boost::filesystem::path> list_xml_files;
+		if (input_file_list == "stdin")
+		{
+			list_xml_files = ReadListOfFiles(std::cin);
+		}
+		else
+		{
+			std::ifstream fInput(input_file_list, std::ios::in | std::ios::binary);
+			if (!fInput.is_open())
+				OpenSMOKE::FatalErrorMessage("The provided @InputFileList cannot be opened: " + input_file_list);
+			list_xml_files = ReadListOfFiles(fInput);
+		}
+
+		// Converted in alphabetical order, as in the other modes
+		std::sort(list_xml_files.begin(), list_xml_files.end());
+
+		for (unsigned int j = 0; j < list_xml_files.size(); j++)
+		{
+			std::string apparatus_kind;
+			std::string experiment_type;
+			ReadExperimentTypeFromXML(list_xml_files[j], apparatus_kind, experiment_type);
+
+			std::cout << j + 1 << "/" << list_xml_files.size() << " ";
+			ConvertRespecthFile(list_xml_files[j], apparatus_kind, experiment_type, path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species, settings, coalesced_experiments);
+		}
+	}
+
 	// Read list of xml files to be converted
-	std::vector<boost::filesystem::path> list_xml_files;
-	if (dictionaries(main_dictionary_name_).CheckOption("@InputFolder") == true)
+	else if (dictionaries(main_dictionary_name_).CheckOption("@InputFolder") == true)
 	{
 		boost::filesystem::path input_folder;
 		dictionaries(main_dictionary_name_).ReadPath("@InputFolder", input_folder);
@@ -172,79 +478,126 @@ int main(int argc, char** argv)
 				OpenSMOKE::FatalErrorMessage("The provided @InputFolder is not a directory, but a file");
 			else if (!boost::filesystem::is_directory(input_folder))
 				OpenSMOKE::FatalErrorMessage("The provided @InputFolder exists, but is neither a regular file nor a directory");
+		}
+
+		// Streaming: subfolders are scanned and files are classified by a bounded pool of tasks, while the
+		// files already classified are converted
+		if (streaming == true)
+		{
+			// Files and subfolders of the input folder, in alphabetical order
+			std::vector<boost::filesystem::path> list_entries;
+			for (boost::filesystem::directory_iterator it(input_folder); it != boost::filesystem::directory_iterator(); ++it)
+			{
+				if (boost::filesystem::is_directory(*it) || (boost::filesystem::is_regular_file(*it) && it->path().extension() == ".xml"))
+					list_entries.push_back(it->path());
+			}
+			std::sort(list_entries.begin(), list_entries.end());
+
+			// One task per subfolder, and one per batch of consecutive files of the input folder, so that
+			// a flat folder is classified in parallel as well
+			const std::size_t batch_size = 64;
+			std::vector< std::vector<boost::filesystem::path> > list_tasks;
+			for (unsigned int k = 0; k < list_entries.size(); k++)
+			{
+				const bool is_folder = boost::filesystem::is_directory(list_entries[k]);
+				if (is_folder == true || list_tasks.empty() == true || boost::filesystem::is_directory(list_tasks.back()[0]) == true || list_tasks.back().size() == batch_size)
+					list_tasks.push_back(std::vector<boost::filesystem::path>());
+				list_tasks.back().push_back(list_entries[k]);
+			}
 
-			boost::filesystem::recursive_directory_iterator it(input_folder);
-			boost::filesystem::recursive_directory_iterator endit;
+			// At most one task per hardware thread runs ahead of the conversion
+			const std::size_t max_running_tasks = std::max(1u, std::thread::hardware_concurrency());
+			std::deque< std::future<ClassifiedFiles> > running_tasks;
+			std::size_t next_task = 0;
 
-			while (it != endit)
+			// Tasks are consumed in the order of the sorted list of all the files (see below), so that the results do not depend on the mode
+			unsigned int count = 0;
+			for (unsigned int k = 0; k < list_tasks.size(); k++)
 			{
-				if (boost::filesystem::is_regular_file(*it) && it->path().extension() == ".xml")
-					list_xml_files.push_back(it->path());
-				++it;
+				while (next_task < list_tasks.size() && running_tasks.size() < max_running_tasks)
+					running_tasks.push_back(std::async(std::launch::async, ClassifyFiles, list_tasks[next_task++]));
+
+				const ClassifiedFiles classified = running_tasks.front().get();
+				running_tasks.pop_front();
+
+				for (unsigned int j = 0; j < classified.files.size(); j++)
+				{
+					std::cout << ++count << " ";
+					ConvertRespecthFile(classified.files[j], classified.apparatus_kinds[j], classified.experiment_types[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species, settings, coalesced_experiments);
+				}
 			}
 		}
-	}
+		else
+		{
+			std::vector<boost::filesystem::path> list_xml_files;
+			{
+				boost::filesystem::recursive_directory_iterator it(input_folder);
+				boost::filesystem::recursive_directory_iterator endit;
+
+				while (it != endit)
+				{
+					if (boost::filesystem::is_regular_file(*it) && it->path().extension() == ".xml")
+						list_xml_files.push_back(it->path());
+					++it;
+				}
+			}
 
-	// Convert files
-	std::vector<std::string> apparatus_kind(list_xml_files.size());
-	std::vector<std::string> experiment_type(list_xml_files.size());
-	for (unsigned int j = 0; j < list_xml_files.size(); j++)
-	{
-		std::cout << list_xml_files[j].string() << std::endl;
+			// The order of the directory walk depends on the file system: the first file converted owns
+			// the dataPoints shared with other files (@DeduplicatePoints), so it must be reproducible
+			std::sort(list_xml_files.begin(), list_xml_files.end());
 
-		boost::property_tree::ptree ptree;
-		boost::property_tree::read_xml(list_xml_files[j].string(), ptree);
+			// Classify files
+			std::vector<std::string> apparatus_kind(list_xml_files.size());
+			std::vector<std::string> experiment_type(list_xml_files.size());
+			for (unsigned int j = 0; j < list_xml_files.size(); j++)
+			{
+				std::cout << list_xml_files[j].string() << std::endl;
 
-		apparatus_kind[j] = ptree.get<std::string>("experiment.apparatus.kind");
-		experiment_type[j] = ptree.get<std::string>("experiment.experimentType");
+				ReadExperimentTypeFromXML(list_xml_files[j], apparatus_kind[j], experiment_type[j]);
 
-		std::cout << j+1 << "/" << list_xml_files.size() << " " << apparatus_kind[j] << " " << experiment_type[j] << std::endl;
+				std::cout << j+1 << "/" << list_xml_files.size() << " " << apparatus_kind[j] << " " << experiment_type[j] << std::endl;
+			}
+
+			// Convert files
+			for (unsigned int j = 0; j < list_xml_files.size(); j++)
+				ConvertRespecthFile(list_xml_files[j], apparatus_kind[j], experiment_type[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species, settings, coalesced_experiments);
+		}
 	}
 
-	for (unsigned int j = 0; j < list_xml_files.size(); j++)
+	else
 	{
-		std::cout << "Converting file: " << list_xml_files[j].filename().string() << std::endl;
-		std::cout << apparatus_kind[j] << " " << experiment_type[j] << std::endl;
+		OpenSMOKE::FatalErrorMessage("Either @InputFolder or @InputFileList must be provided");
+	}
 
-		if (experiment_type[j] == "jet stirred reactor measurement")
-		{
-			Respecth2OpenSMOKEpp_JetStirredReactor reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile( (list_xml_files[j].filename().string() + ".dic" ) );
-		}
+	// Coalesced experiments are written once all the files are converted
+	coalesced.WriteOnASCIIFiles();
 
-		else if (experiment_type[j] == "laminar burning velocity measurement")
-		{
-			Respecth2OpenSMOKEpp_LaminarBurningVelocity reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile((list_xml_files[j].filename().string() + ".dic"));
-		}
+	// Reference table of the dataPoints simulated in the dictionaries of other experiments
+	if (settings.deduplicate_points_ == true)
+		SharedPoints::Instance().WriteOnFile(path_output_folder_remote / "shared_points.txt");
 
-		else if (experiment_type[j] == "burner stabilized flame speciation measurement")
-		{
-			Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile((list_xml_files[j].filename().string() + ".dic"));
-		}
+	// Statistics
+	if (print_statistics == true)
+	{
+		PerformanceStatistics::Instance().Summary(std::cout);
+		if (statistics_file_name.empty() == false)
+			PerformanceStatistics::Instance().WriteOnJSONFile(statistics_file_name);
+	}
 
-		else if (experiment_type[j] == "concentration time profile measurement")
-		{
-			Respecth2OpenSMOKEpp_ConcentrationTimeProfile reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile((list_xml_files[j].filename().string() + ".dic"));
-		}
+	if (print_memory_statistics == true)
+		MemoryStatistics::Instance().Summary(std::cout);
 
-		else if (experiment_type[j] == "outlet concentration measurement")
-		{
-			Respecth2OpenSMOKEpp_OutletConcentration reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile((list_xml_files[j].filename().string() + ".dic"));
-		}
+	if (manifest_file_name.empty() == false)
+		JobManifest::Instance().WriteOnFile(manifest_file_name, sort_by_cost);
 
-		else if (experiment_type[j] == "ignition delay measurement")
-		{
-			Respecth2OpenSMOKEpp_IgnitionDelay reactor(list_xml_files[j], path_kinetics_folder_remote, path_output_folder_remote, species_in_kinetic_mech, case_sensitive, database_species);
-			reactor.WriteOnASCIIFile((list_xml_files[j].filename().string() + ".dic"));
-		}
+	if (number_of_bundles != 0)
+		JobManifest::Instance().WriteBundles(path_output_folder_remote, number_of_bundles);
 
-		else
-		{
-			OpenSMOKE::FatalErrorMessage("Unknown experiment type: " + experiment_type[j]);
-		}
-	}
-}
\ No newline at end of file
+	if (ninja_pool_depth != 0)
+		JobManifest::Instance().WriteNinjaFile(path_output_folder_remote, ninja_pool_depth);
+
+	// All the scan tasks have been joined: no thread is recording events anymore
+	TraceEvents::Instance().Flush();
+
+	return OPENSMOKE_SUCCESSFULL_EXIT;
+}
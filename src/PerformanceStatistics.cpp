@@ -0,0 +1,244 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "PerformanceStatistics.h"
+#include "TraceEvents.h"
+#include "MemoryStatistics.h"
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <algorithm>
+
+// Experiment type of the file which is currently converted by the calling thread
+static thread_local std::string current_experiment_type_ = "unclassified";
+
+PerformanceStatistics& PerformanceStatistics::Instance()
+{
+	static PerformanceStatistics instance;
+	return instance;
+}
+
+PerformanceStatistics::PerformanceStatistics() :
+	is_active_(false)
+{
+	start_ = std::chrono::steady_clock::now();
+}
+
+void PerformanceStatistics::SetActive(const bool flag)
+{
+	is_active_ = flag;
+	start_ = std::chrono::steady_clock::now();
+}
+
+void PerformanceStatistics::SetExperimentType(const std::string& experiment_type)
+{
+	current_experiment_type_ = (experiment_type.empty() == true) ? "unclassified" : experiment_type;
+}
+
+void PerformanceStatistics::AddTime(const char* stage, const double seconds)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	StageData& data = records_[current_experiment_type_].stages[stage];
+	data.calls++;
+	data.total += seconds;
+	data.max = std::max(data.max, seconds);
+}
+
+void PerformanceStatistics::Add(const Counter counter, const std::size_t value)
+{
+	if (is_active_ == false)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	records_[current_experiment_type_].counters[static_cast<int>(counter)] += value;
+}
+
+void PerformanceStatistics::SumUp(Record& aggregate) const
+{
+	for (std::map<std::string, Record>::const_iterator it = records_.begin(); it != records_.end(); ++it)
+	{
+		for (std::map<std::string, StageData>::const_iterator jt = it->second.stages.begin(); jt != it->second.stages.end(); ++jt)
+		{
+			StageData& data = aggregate.stages[jt->first];
+			data.calls += jt->second.calls;
+			data.total += jt->second.total;
+			data.max = std::max(data.max, jt->second.max);
+		}
+
+		for (unsigned int k = 0; k < 5; k++)
+			aggregate.counters[k] += it->second.counters[k];
+	}
+}
+
+namespace
+{
+	void WriteRecord(std::ostream& out, const std::string& name, const std::map<std::string, PerformanceStatistics::StageData>& stages, const std::size_t* counters, const double time)
+	{
+		out << std::endl;
+		out << name << std::endl;
+		out << std::left << std::setw(28) << "  Stage" << std::right << std::setw(12) << "Calls" << std::setw(14) << "Total[s]" << std::setw(14) << "Mean[ms]" << std::setw(14) << "Max[ms]" << std::endl;
+
+		for (std::map<std::string, PerformanceStatistics::StageData>::const_iterator it = stages.begin(); it != stages.end(); ++it)
+		{
+			out << std::left << std::setw(28) << ("  " + it->first) << std::right;
+			out << std::setw(12) << it->second.calls;
+			out << std::setw(14) << std::fixed << std::setprecision(4) << it->second.total;
+			out << std::setw(14) << std::fixed << std::setprecision(4) << it->second.total / static_cast<double>(it->second.calls) * 1.e3;
+			out << std::setw(14) << std::fixed << std::setprecision(4) << it->second.max * 1.e3;
+			out << std::endl;
+		}
+
+		const double MB = 1024. * 1024.;
+		out << "  Files: " << counters[0] << "  DataPoints: " << counters[1] << "  Species: " << counters[2];
+		out << "  Read: " << std::setprecision(3) << counters[3] / MB << " MB  Written: " << counters[4] / MB << " MB" << std::endl;
+
+		if (time > 0.)
+		{
+			out << "  Throughput: " << std::setprecision(2) << counters[0] / time << " files/s  ";
+			out << counters[1] / time << " dataPoints/s  " << counters[3] / MB / time << " MB/s (read)" << std::endl;
+		}
+
+		out.unsetf(std::ios::fixed);
+	}
+
+	void WriteRecordOnJSON(std::ostream& out, const std::string& name, const std::map<std::string, PerformanceStatistics::StageData>& stages, const std::size_t* counters, const double time)
+	{
+		out << "    {" << std::endl;
+		out << "      \"name\": \"" << name << "\"," << std::endl;
+		out << "      \"time\": " << time << "," << std::endl;
+		out << "      \"files\": " << counters[0] << "," << std::endl;
+		out << "      \"dataPoints\": " << counters[1] << "," << std::endl;
+		out << "      \"species\": " << counters[2] << "," << std::endl;
+		out << "      \"bytesRead\": " << counters[3] << "," << std::endl;
+		out << "      \"bytesWritten\": " << counters[4] << "," << std::endl;
+		out << "      \"stages\": {";
+		for (std::map<std::string, PerformanceStatistics::StageData>::const_iterator it = stages.begin(); it != stages.end(); ++it)
+		{
+			out << ((it == stages.begin()) ? "" : ",") << std::endl;
+			out << "        \"" << it->first << "\": { \"calls\": " << it->second.calls << ", \"total\": " << it->second.total << ", \"max\": " << it->second.max << " }";
+		}
+		out << std::endl << "      }" << std::endl;
+		out << "    }";
+	}
+}
+
+void PerformanceStatistics::Summary(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+	out << std::endl;
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+	out << " Performance statistics (stage times are inclusive of nested stages)" << std::endl;
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+
+	// Throughput of each experiment type is referred to the time spent converting its files
+	for (std::map<std::string, Record>::const_iterator it = records_.begin(); it != records_.end(); ++it)
+	{
+		std::map<std::string, StageData>::const_iterator file = it->second.stages.find("file");
+		const double time = (file != it->second.stages.end()) ? file->second.total : 0.;
+		WriteRecord(out, it->first, it->second.stages, it->second.counters, time);
+	}
+
+	Record aggregate;
+	SumUp(aggregate);
+	WriteRecord(out, "Aggregate (wall clock time: " + std::to_string(wall_time) + " s)", aggregate.stages, aggregate.counters, wall_time);
+
+	out << "-------------------------------------------------------------------------------------" << std::endl;
+	out << std::endl;
+}
+
+void PerformanceStatistics::WriteOnJSONFile(const boost::filesystem::path& file_name) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+	std::ofstream fOut(file_name.string(), std::ios::out);
+	fOut.setf(std::ios::scientific);
+
+	fOut << "{" << std::endl;
+	fOut << "  \"experimentTypes\": [" << std::endl;
+	for (std::map<std::string, Record>::const_iterator it = records_.begin(); it != records_.end(); ++it)
+	{
+		std::map<std::string, StageData>::const_iterator file = it->second.stages.find("file");
+		const double time = (file != it->second.stages.end()) ? file->second.total : 0.;
+		WriteRecordOnJSON(fOut, it->first, it->second.stages, it->second.counters, time);
+		fOut << ((std::next(it) != records_.end()) ? "," : "") << std::endl;
+	}
+	fOut << "  ]," << std::endl;
+
+	Record aggregate;
+	SumUp(aggregate);
+	fOut << "  \"aggregate\":" << std::endl;
+	WriteRecordOnJSON(fOut, "aggregate", aggregate.stages, aggregate.counters, wall_time);
+	fOut << std::endl << "}" << std::endl;
+
+	fOut.close();
+}
+
+ScopedStageTimer::ScopedStageTimer(const char* stage) :
+	stage_(stage)
+{
+	is_active_ = PerformanceStatistics::Instance().is_active();
+	if (is_active_ == true)
+		start_ = std::chrono::steady_clock::now();
+
+	is_traced_ = TraceEvents::Instance().is_active();
+	if (is_traced_ == true)
+		TraceEvents::Instance().Begin(stage_);
+
+	is_memory_profiled_ = MemoryStatistics::Instance().is_active();
+	if (is_memory_profiled_ == true)
+	{
+		memory_mark_ = MemoryStatistics::Instance().BeginStage();
+	}
+}
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+	if (is_active_ == true)
+		PerformanceStatistics::Instance().AddTime(stage_, std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+
+	if (is_traced_ == true)
+		TraceEvents::Instance().End(stage_);
+
+	if (is_memory_profiled_ == true)
+		MemoryStatistics::Instance().EndStage(stage_, memory_mark_);
+}
@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "MemoryStatistics.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <boost/filesystem.hpp>
+
+class PerformanceStatistics
+{
+public:
+
+	enum class Counter { FILES, DATAPOINTS, SPECIES, BYTES_READ, BYTES_WRITTEN };
+
+	struct StageData
+	{
+		std::size_t calls = 0;
+		double total = 0.;
+		double max = 0.;
+	};
+
+	struct Record
+	{
+		std::map<std::string, StageData> stages;
+		std::size_t counters[5] = { 0, 0, 0, 0, 0 };
+	};
+
+	static PerformanceStatistics& Instance();
+
+	void SetActive(const bool flag);
+
+	bool is_active() const { return is_active_; }
+
+	void SetExperimentType(const std::string& experiment_type);
+
+	void AddTime(const char* stage, const double seconds);
+
+	void Add(const Counter counter, const std::size_t value);
+
+	void Summary(std::ostream& out) const;
+
+	void WriteOnJSONFile(const boost::filesystem::path& file_name) const;
+
+private:
+
+	PerformanceStatistics();
+
+	void SumUp(Record& aggregate) const;
+
+	std::atomic<bool> is_active_;
+	std::chrono::steady_clock::time_point start_;
+
+	std::map<std::string, Record> records_;
+	mutable std::mutex mutex_;
+};
+
+class ScopedStageTimer
+{
+public:
+
+	explicit ScopedStageTimer(const char* stage);
+
+	~ScopedStageTimer();
+
+private:
+
+	const char* stage_;
+	bool is_active_;
+	bool is_traced_;
+	bool is_memory_profiled_;
+	MemoryStatistics::Mark memory_mark_;
+	std::chrono::steady_clock::time_point start_;
+};
@@ -35,15 +35,28 @@
 \*-----------------------------------------------------------------------*/
 
 #include "Respecth2OpenSMOKEpp.h"
+#include "PerformanceStatistics.h"
+#include "JobManifest.h"
+#include "SharedPoints.h"
 #include <boost/algorithm/string/replace.hpp>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
 
 Respecth2OpenSMOKEpp::Respecth2OpenSMOKEpp(	boost::filesystem::path file_name, 
 											const boost::filesystem::path kinetics_folder,
 											const boost::filesystem::path output_folder,
 											const std::vector<std::string> species_in_kinetic_mech,
 											const bool case_sensitive,
-											DatabaseSpecies& database_species) :
-database_species_(database_species) 
+											DatabaseSpecies& database_species,
+											const ConversionSettings& settings) :
+database_species_(database_species),
+settings_(settings),
+preset_(PresetOfFidelity(settings.fidelity_))
 {
 	kinetics_folder_ = kinetics_folder;
 
@@ -51,7 +64,32 @@ database_species_(database_species)
 
 	case_sensitive_ = case_sensitive;
 
-	boost::property_tree::read_xml(file_name.string(), ptree_);
+	// The parser reads the file in its own buffer: no other copy of the (possibly large) file is kept
+	std::ifstream fInput;
+	{
+		ScopedStageTimer timer("read");
+		fInput.open(file_name.string(), std::ios::in | std::ios::binary);
+		PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::BYTES_READ, static_cast<std::size_t>(boost::filesystem::file_size(file_name)));
+	}
+
+	// Parse the XML tree
+	{
+		ScopedStageTimer timer("parse");
+		boost::property_tree::read_xml(fInput, ptree_);
+		fInput.close();
+	}
+
+	// Number of dataPoints (statistics only)
+	if (PerformanceStatistics::Instance().is_active() == true)
+	{
+		std::size_t n = 0;
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& node, ptree_.get_child("experiment"))
+			if (node.first == "dataGroup")
+				n += node.second.count("dataPoint");
+		PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::DATAPOINTS, n);
+	}
+
+	ScopedStageTimer timer("metadata");
 
 	// File author (M)
 	try
@@ -111,17 +149,692 @@ database_species_(database_species)
 
 void Respecth2OpenSMOKEpp::WriteOnASCIIFile(boost::filesystem::path file_name)
 {
+	ScopedStageTimer timer("write");
+
 	std::cout << " * Writing output OpenSMOKE++ file(s)..." << std::endl;
 
-	std::ofstream fOut( (output_folder_ / file_name).string(), std::ios::out);
+	if (settings_.restrict_output_species_ == true)
+		DefineOutputSpecies();
+
+	if (settings_.automatic_tolerances_ == true)
+		SelectTolerances();
+
+	DefineGroupsOfPoints();
+
+	if (settings_.deduplicate_points_ == true && RemoveSharedPoints() == false)
+	{
+		std::cout << "   - all the dataPoints are simulated in other dictionaries: nothing to write" << std::endl;
+		return;
+	}
+
+	if (settings_.reorder_points_ == true)
+		ReorderPoints();
+
+	if (settings_.max_points_per_dictionary_ > 0)
+		SplitGroupsOfPoints(static_cast<std::size_t>(settings_.max_points_per_dictionary_));
+
+	if (groups_.size() <= 1)
+	{
+		// A single group with all the dataPoints in their original order is the same as no selection
+		if (groups_.size() == 1 && (std::is_sorted(groups_[0].begin(), groups_[0].end()) == false || groups_[0].size() != NumberOfPoints()))
+			points_ = groups_[0];
+
+		groups_.clear();
+		WriteDictionary(output_folder_ / file_name);
+		points_.clear();
+	}
+	else
+	{
+		// One dictionary (and one output folder) for each group: <name>.<k>.dic
+		const boost::filesystem::path output_folder_simulation = output_folder_simulation_;
+		for (unsigned int k = 0; k < groups_.size(); k++)
+		{
+			points_ = groups_[k];
+
+			output_folder_simulation_ = output_folder_simulation;
+			output_folder_simulation_ += "." + std::to_string(k + 1);
+
+			boost::filesystem::path file_name_group = file_name.stem();
+			file_name_group += "." + std::to_string(k + 1) + file_name.extension().string();
+			WriteDictionary(output_folder_ / file_name_group);
+		}
+		output_folder_simulation_ = output_folder_simulation;
+		points_.clear();
+	}
+
+	WriteAdditionalFiles();
+}
+
+std::string Respecth2OpenSMOKEpp::KeyOfCommonConditions() const
+{
+	std::ostringstream key;
+	key << std::setprecision(17);
+
+	key << experiment_type_ << "|" << kinetics_folder_.string() << "|" << t_units_ << "|";
+	for (unsigned int i = 0; i < p_values_.size(); i++)
+		key << p_values_[i] << " ";
+	key << p_units_ << "|";
+	for (unsigned int i = 0; i < v_values_.size(); i++)
+		key << v_values_[i] << " ";
+	key << v_units_ << "|";
+	for (unsigned int i = 0; i < dpdt_values_.size(); i++)
+		key << dpdt_values_[i] << " ";
+	key << dpdt_units_ << "|";
+	for (unsigned int i = 0; i < initial_compositions_.size(); i++)
+	{
+		for (unsigned int j = 0; j < initial_compositions_[i].names().size(); j++)
+			key << initial_compositions_[i].names()[j] << "=" << initial_compositions_[i].values()[j] << " ";
+		key << "|";
+	}
+
+	return key.str();
+}
+
+void Respecth2OpenSMOKEpp::Coalesce(const Respecth2OpenSMOKEpp& other)
+{
+	if (sources_.size() == 0)
+		sources_.push_back(std::make_pair(file_name_xml_.filename().string(), NumberOfPoints()));
+	sources_.push_back(std::make_pair(other.file_name_xml_.filename().string(), other.NumberOfPoints()));
+
+	t_values_.insert(t_values_.end(), other.t_values_.begin(), other.t_values_.end());
+
+	// Measured data of all the experiments (output species, automatic tolerances)
+	boost::property_tree::ptree& experiment = ptree_.get_child("experiment");
+	BOOST_FOREACH(boost::property_tree::ptree::value_type const& node, other.ptree_.get_child("experiment"))
+		if (node.first == "dataGroup")
+			experiment.push_back(node);
+}
+
+void Respecth2OpenSMOKEpp::WriteCoalescedOnASCIIFile(const std::string& name)
+{
+	output_folder_simulation_ = output_folder_ / name;
+	WriteOnASCIIFile(name + ".dic");
+}
+
+void Respecth2OpenSMOKEpp::CompactXMLTree()
+{
+	// After the construction, only the measured compositions are read from the tree (output species and automatic tolerances)
+	boost::property_tree::ptree experiment;
+	BOOST_FOREACH(boost::property_tree::ptree::value_type const& node, ptree_.get_child("experiment"))
+	{
+		if (node.first != "dataGroup")
+			continue;
+
+		boost::property_tree::ptree group;
+		std::vector<std::string> ids;
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& property, node.second)
+		{
+			if (property.first != "property")
+				continue;
+
+			const std::string name = property.second.get<std::string>("<xmlattr>.name", "");
+			if (name == "composition" || name == "concentration")
+			{
+				group.push_back(property);
+				ids.push_back(property.second.get<std::string>("<xmlattr>.id", ""));
+			}
+		}
+
+		if (ids.size() == 0)
+			continue;
+
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& point, node.second)
+		{
+			if (point.first != "dataPoint")
+				continue;
+
+			boost::property_tree::ptree values;
+			BOOST_FOREACH(boost::property_tree::ptree::value_type const& value, point.second)
+				if (std::find(ids.begin(), ids.end(), value.first) != ids.end())
+					values.push_back(value);
+			group.push_back(std::make_pair("dataPoint", values));
+		}
+
+		experiment.push_back(std::make_pair("dataGroup", group));
+	}
+
+	ptree_.clear();
+	ptree_.add_child("experiment", experiment);
+}
+
+void Respecth2OpenSMOKEpp::WriteDictionary(const boost::filesystem::path& file_name)
+{
+	// Written aside and moved in place only if changed, so that unchanged dictionaries keep their modification time
+	boost::filesystem::path temporary_file_name = file_name;
+	temporary_file_name += ".tmp";
+
+	std::ofstream fOut(temporary_file_name.string(), std::ios::out);
 	fOut.setf(std::ios::scientific);
 
 	WriteHeaderText(fOut);
 	WriteMetaData(fOut);
 	WriteSimulationData(fOut);
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::BYTES_WRITTEN, static_cast<std::size_t>(fOut.tellp()));
 	fOut.close();
 
-	WriteAdditionalFiles();
+	ReplaceFileIfChanged(temporary_file_name, file_name);
+
+	if (JobManifest::Instance().is_active() == true)
+	{
+		JobManifest::Job job;
+		job.dictionary = file_name.string();
+		job.experiment_type = experiment_type_;
+		job.solver = Solver();
+		job.output_folder = output_folder_simulation_.string();
+		job.points = NumberOfPoints();
+		job.cost = EstimatedCost();
+
+		// The kinetic mechanism is preprocessed in a single pass, which always rewrites kinetics.xml
+		job.inputs.push_back((kinetics_folder_ / "kinetics.xml").string());
+		const std::vector<boost::filesystem::path> input_files = InputFiles();
+		for (unsigned int i = 0; i < input_files.size(); i++)
+			job.inputs.push_back(input_files[i].string());
+
+		JobManifest::Instance().Add(job);
+	}
+}
+
+std::vector< std::vector<unsigned int> > Respecth2OpenSMOKEpp::BucketsOfPoints(const std::vector<double>& values, const double ratio) const
+{
+	std::vector<unsigned int> indices(values.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	std::stable_sort(indices.begin(), indices.end(), [&values](const unsigned int a, const unsigned int b) { return values[a] < values[b]; });
+
+	std::vector< std::vector<unsigned int> > buckets;
+	for (unsigned int i = 0; i < indices.size(); i++)
+	{
+		if (buckets.size() == 0 || values[indices[i]] > ratio * values[buckets.back().front()])
+			buckets.push_back(std::vector<unsigned int>());
+		buckets.back().push_back(indices[i]);
+	}
+
+	// Original order within each bucket
+	for (unsigned int k = 0; k < buckets.size(); k++)
+		std::sort(buckets[k].begin(), buckets[k].end());
+
+	return buckets;
+}
+
+std::vector< std::vector<double> > Respecth2OpenSMOKEpp::CoordinatesOfPoints() const
+{
+	std::vector< std::vector<double> > coordinates;
+	coordinates.push_back(t_values_);
+	coordinates.push_back(p_values_);
+	coordinates.push_back(phi_values_);
+
+	// One coordinate for each species in the compositions
+	if (initial_compositions_.size() > 1)
+	{
+		std::vector<std::string> species;
+		for (unsigned int i = 0; i < initial_compositions_.size(); i++)
+			for (unsigned int j = 0; j < initial_compositions_[i].names().size(); j++)
+				if (std::find(species.begin(), species.end(), initial_compositions_[i].names()[j]) == species.end())
+					species.push_back(initial_compositions_[i].names()[j]);
+
+		for (unsigned int k = 0; k < species.size(); k++)
+		{
+			std::vector<double> x(initial_compositions_.size(), 0.);
+			for (unsigned int i = 0; i < initial_compositions_.size(); i++)
+			{
+				const std::vector<std::string>& names = initial_compositions_[i].names();
+				const std::vector<std::string>::const_iterator it = std::find(names.begin(), names.end(), species[k]);
+				if (it != names.end())
+					x[i] = initial_compositions_[i].values()[std::distance(names.begin(), it)];
+			}
+			coordinates.push_back(x);
+		}
+	}
+
+	return coordinates;
+}
+
+std::size_t Respecth2OpenSMOKEpp::NumberOfPoints() const
+{
+	if (points_.size() != 0)
+		return points_.size();
+
+	const std::vector< std::vector<double> > coordinates = CoordinatesOfPoints();
+
+	std::size_t n = std::max<std::size_t>(1, tau_values_.size());
+	for (unsigned int j = 0; j < coordinates.size(); j++)
+		n = std::max(n, coordinates[j].size());
+	return n;
+}
+
+double Respecth2OpenSMOKEpp::CostOfReactor(const double end_time, const std::size_t profile_points) const
+{
+	// Without a kinetic mechanism a medium size one is assumed
+	const double ns = (species_in_kinetic_mech_.size() != 0) ? static_cast<double>(species_in_kinetic_mech_.size()) : 100.;
+
+	// Stiff solvers take a similar number of steps for each decade of time, starting from very small steps
+	// (unknown end time: 10 decades); every point of an imposed profile forces an additional step
+	const double decades = (end_time > 0.) ? std::max(1., std::log10(end_time / 1.e-10)) : 10.;
+	const double steps = 10. * decades + static_cast<double>(profile_points);
+
+	// Number of steps growing with the required digits, sparse factorization of the Jacobian at each step
+	return steps * -std::log10(preset_.rel_tolerance_) * ns * ns;
+}
+
+double Respecth2OpenSMOKEpp::CostOfFlame(const int grid_points) const
+{
+	const double ns = (species_in_kinetic_mech_.size() != 0) ? static_cast<double>(species_in_kinetic_mech_.size()) : 100.;
+
+	// Block-tridiagonal Newton iterations on the largest grid allowed
+	return -std::log10(preset_.rel_tolerance_) * grid_points * ns * ns * ns;
+}
+
+int Respecth2OpenSMOKEpp::StepsBetweenSamples(const std::vector<double>& times) const
+{
+	std::vector<double> sorted = times;
+	std::sort(sorted.begin(), sorted.end());
+
+	// Closest measured times, in decades (the integration starts from very small steps, as in CostOfReactor)
+	double previous = 1.e-10;
+	double min_decades = std::numeric_limits<double>::max();
+	for (unsigned int i = 0; i < sorted.size(); i++)
+	{
+		if (sorted[i] > previous)
+		{
+			min_decades = std::min(min_decades, std::log10(sorted[i] / previous));
+			previous = sorted[i];
+		}
+	}
+	if (min_decades == std::numeric_limits<double>::max())
+		return 1;
+
+	// 10 steps per decade for each required digit, at least 4 outputs between two measured times
+	const double steps_per_decade = 10. * -std::log10(preset_.rel_tolerance_);
+	return std::max(1, static_cast<int>(steps_per_decade * min_decades / 4.));
+}
+
+double Respecth2OpenSMOKEpp::EstimatedCost() const
+{
+	return NumberOfPoints() * CostOfReactor();
+}
+
+void Respecth2OpenSMOKEpp::ReorderPoints()
+{
+	const std::vector< std::vector<double> > coordinates = CoordinatesOfPoints();
+
+	std::size_t n = 0;
+	for (unsigned int j = 0; j < coordinates.size(); j++)
+		n = std::max(n, coordinates[j].size());
+	if (n <= 1)
+		return;
+
+	// No groups: all the dataPoints in a single dictionary
+	if (groups_.size() == 0)
+	{
+		groups_.push_back(std::vector<unsigned int>(n));
+		std::iota(groups_[0].begin(), groups_[0].end(), 0);
+	}
+
+	for (unsigned int k = 0; k < groups_.size(); k++)
+		groups_[k] = NearestNeighbourPath(groups_[k], coordinates);
+}
+
+bool Respecth2OpenSMOKEpp::RemoveSharedPoints()
+{
+	const std::size_t n = NumberOfPoints();
+	if (KeyOfPoint(0).empty() == true)
+		return true;
+
+	// Source file of each dataPoint (coalesced experiments: the file it was read from)
+	std::vector<SharedPoints::Source> sources(n);
+	for (unsigned int i = 0; i < n; i++)
+		sources[i] = { file_name_xml_.filename().string(), i + 1 };
+	std::size_t first = 0;
+	for (unsigned int k = 0; k < sources_.size(); k++)
+	{
+		for (std::size_t i = first; i < first + sources_[k].second && i < n; i++)
+			sources[i] = { sources_[k].first, i - first + 1 };
+		first += sources_[k].second;
+	}
+
+	std::vector<bool> shared(n, false);
+	std::size_t n_shared = 0;
+	for (unsigned int i = 0; i < n; i++)
+	{
+		const SharedPoints::Source simulated = SharedPoints::Instance().Register(KeyOfPoint(i), sources[i]);
+		if (simulated.file != sources[i].file || simulated.point != sources[i].point)
+		{
+			shared[i] = true;
+			n_shared++;
+		}
+	}
+
+	if (n_shared == 0)
+		return true;
+
+	std::cout << "   - shared dataPoints: " << n_shared << " of " << n << " (simulated in other dictionaries)" << std::endl;
+
+	// No groups: all the dataPoints in a single dictionary
+	if (groups_.size() == 0)
+	{
+		groups_.push_back(std::vector<unsigned int>(n));
+		std::iota(groups_[0].begin(), groups_[0].end(), 0);
+	}
+
+	std::vector< std::vector<unsigned int> > groups;
+	for (unsigned int k = 0; k < groups_.size(); k++)
+	{
+		std::vector<unsigned int> group;
+		std::copy_if(groups_[k].begin(), groups_[k].end(), std::back_inserter(group), [&shared](const unsigned int i) { return shared[i] == false; });
+		if (group.size() != 0)
+			groups.push_back(group);
+	}
+
+	groups_ = groups;
+	return (groups_.size() != 0);
+}
+
+std::string Respecth2OpenSMOKEpp::CanonicalValue(const std::vector<double>& values, const std::string& units, const unsigned int i) const
+{
+	if (values.size() == 0)
+		return "-";
+
+	const double value = ValueInSIUnits((values.size() == 1) ? values[0] : values[i], units);
+	const int digits = std::max(1, static_cast<int>(std::ceil(-std::log10(settings_.deduplication_tolerance_))));
+
+	std::ostringstream canonical;
+	canonical << std::setprecision(digits) << value;
+	return canonical.str();
+}
+
+std::string Respecth2OpenSMOKEpp::KeyOfConditions(const unsigned int i) const
+{
+	std::ostringstream key;
+	key << Solver() << "|" << kinetics_folder_.string() << "|";
+	key << "T=" << CanonicalValue(t_values_, t_units_, i) << "|";
+	key << "p=" << CanonicalValue(p_values_, p_units_, i) << "|";
+
+	// Composition sorted by species name (species with zero mole fraction are skipped)
+	const Composition& composition = (initial_compositions_.size() == 1) ? initial_compositions_[0] : initial_compositions_[i];
+	std::vector< std::pair<std::string, double> > x;
+	for (unsigned int j = 0; j < composition.names().size(); j++)
+		if (composition.values()[j] != 0.)
+			x.push_back(std::make_pair(composition.names()[j], composition.values()[j]));
+	std::sort(x.begin(), x.end());
+	key << "x=";
+	for (unsigned int j = 0; j < x.size(); j++)
+		key << x[j].first << ":" << CanonicalValue(std::vector<double>(1, x[j].second), "", 0) << " ";
+	key << "|";
+
+	std::vector<std::string> output_species = output_species_;
+	std::sort(output_species.begin(), output_species.end());
+	key << "out=";
+	for (unsigned int j = 0; j < output_species.size(); j++)
+		key << output_species[j] << " ";
+	key << "|";
+
+	key << std::setprecision(17) << "tol=" << preset_.abs_tolerance_ << " " << preset_.rel_tolerance_ << "|";
+
+	return key.str();
+}
+
+void Respecth2OpenSMOKEpp::SplitGroupsOfPoints(const std::size_t max_points)
+{
+	// No groups: all the dataPoints in a single dictionary
+	if (groups_.size() == 0)
+	{
+		const std::size_t n = NumberOfPoints();
+		if (n <= max_points)
+			return;
+
+		groups_.push_back(std::vector<unsigned int>(n));
+		std::iota(groups_[0].begin(), groups_[0].end(), 0);
+	}
+
+	// Consecutive chunks of similar size, so that the (possibly reordered) sequence of dataPoints is preserved
+	std::vector< std::vector<unsigned int> > chunks;
+	for (unsigned int k = 0; k < groups_.size(); k++)
+	{
+		const std::size_t n = groups_[k].size();
+		const std::size_t n_chunks = (n + max_points - 1) / max_points;
+		for (std::size_t j = 0; j < n_chunks; j++)
+			chunks.push_back(std::vector<unsigned int>(groups_[k].begin() + j * n / n_chunks, groups_[k].begin() + (j + 1) * n / n_chunks));
+	}
+
+	groups_ = chunks;
+}
+
+std::vector<unsigned int> Respecth2OpenSMOKEpp::NearestNeighbourPath(const std::vector<unsigned int>& points, const std::vector< std::vector<double> >& coordinates) const
+{
+	if (points.size() <= 2)
+		return points;
+
+	// Variables which change among the dataPoints, normalized with their range
+	std::vector< std::vector<double> > x;
+	for (unsigned int j = 0; j < coordinates.size(); j++)
+	{
+		if (coordinates[j].size() <= 1)
+			continue;
+
+		double min = coordinates[j][points[0]];
+		double max = coordinates[j][points[0]];
+		for (unsigned int i = 1; i < points.size(); i++)
+		{
+			min = std::min(min, coordinates[j][points[i]]);
+			max = std::max(max, coordinates[j][points[i]]);
+		}
+
+		if (max > min)
+		{
+			std::vector<double> xj(points.size());
+			for (unsigned int i = 0; i < points.size(); i++)
+				xj[i] = (coordinates[j][points[i]] - min) / (max - min);
+			x.push_back(xj);
+		}
+	}
+	if (x.size() == 0)
+		return points;
+
+	// Start from the lowest value of the first variable, then move to the closest dataPoint not yet visited
+	std::vector<bool> visited(points.size(), false);
+	std::vector<unsigned int> path;
+	path.reserve(points.size());
+
+	unsigned int current = static_cast<unsigned int>(std::distance(x[0].begin(), std::min_element(x[0].begin(), x[0].end())));
+	for (;;)
+	{
+		visited[current] = true;
+		path.push_back(points[current]);
+		if (path.size() == points.size())
+			break;
+
+		double closest_distance = 0.;
+		unsigned int closest = 0;
+		bool found = false;
+		for (unsigned int i = 0; i < points.size(); i++)
+		{
+			if (visited[i] == true)
+				continue;
+
+			double distance = 0.;
+			for (unsigned int j = 0; j < x.size(); j++)
+				distance += (x[j][i] - x[j][current]) * (x[j][i] - x[j][current]);
+
+			if (found == false || distance < closest_distance)
+			{
+				closest_distance = distance;
+				closest = i;
+				found = true;
+			}
+		}
+		current = closest;
+	}
+
+	return path;
+}
+
+bool Respecth2OpenSMOKEpp::OdeParametersRequired() const
+{
+	return settings_.fidelity_ != ConversionSettings::Fidelity::PRODUCTION || settings_.automatic_tolerances_ == true;
+}
+
+void Respecth2OpenSMOKEpp::SelectTolerances()
+{
+	const FidelityPreset preset = PresetOfFidelity(settings_.fidelity_);
+
+	// Smallest (non zero) mole fraction measured in the dataGroups
+	double x_min = 0.;
+	BOOST_FOREACH(boost::property_tree::ptree::value_type const& node, ptree_.get_child("experiment"))
+	{
+		if (node.first != "dataGroup")
+			continue;
+
+		std::vector<std::string> ids;
+		std::vector<double> factors;
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& property, node.second)
+		{
+			if (property.first != "property")
+				continue;
+
+			const std::string name = property.second.get<std::string>("<xmlattr>.name", "");
+			if (name != "composition" && name != "concentration")
+				continue;
+
+			const std::string units = property.second.get<std::string>("<xmlattr>.units", "");
+			double factor = 0.;
+			if (units == "mole fraction")	factor = 1.;
+			else if (units == "percent")	factor = 1.e-2;
+			else if (units == "ppm")		factor = 1.e-6;
+			else if (units == "ppb")		factor = 1.e-9;
+
+			if (factor != 0.)
+			{
+				ids.push_back(property.second.get<std::string>("<xmlattr>.id", ""));
+				factors.push_back(factor);
+			}
+		}
+
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& point, node.second)
+		{
+			if (point.first != "dataPoint")
+				continue;
+
+			for (unsigned int j = 0; j < ids.size(); j++)
+			{
+				const double x = point.second.get<double>(ids[j], 0.) * factors[j];
+				if (x > 0. && (x_min == 0. || x < x_min))
+					x_min = x;
+			}
+		}
+	}
+
+	std::ostringstream reason;
+	reason.setf(std::ios::scientific);
+	reason.precision(2);
+
+	// Ignition criteria based on a given amount of the target species
+	const bool idt_amount = (idt_.type_ == "concentration" || idt_.type_ == "relative concentration") && idt_.units_ == "mole fraction" && idt_.amount_ > 0.;
+	if (idt_amount == true && (x_min == 0. || idt_.amount_ < x_min))
+	{
+		x_min = idt_.amount_;
+		reason << "target amount of ignition criterion " << x_min << "; ";
+	}
+	else if (x_min != 0.)
+		reason << "smallest measured mole fraction " << x_min << "; ";
+
+	// The absolute tolerance resolves the smallest quantity with 6 significant digits
+	preset_.abs_tolerance_ = preset.abs_tolerance_;
+	if (x_min != 0.)
+	{
+		preset_.abs_tolerance_ = std::min(1e-8, std::max(1e-20, 1e-6 * x_min));
+		reason << "absolute tolerance " << preset_.abs_tolerance_;
+	}
+	// Ignition delays detected from temperature or pressure: no species to be resolved
+	else if (idt_.target_ == "T" || idt_.target_ == "p")
+	{
+		preset_.abs_tolerance_ = std::max(preset.abs_tolerance_, 1e-10);
+		reason << "ignition detected from " << (idt_.target_ == "T" ? "temperature" : "pressure") << ", no measured species; absolute tolerance " << preset_.abs_tolerance_;
+	}
+	else
+		reason << "no measured mole fractions; absolute tolerance of the preset " << preset_.abs_tolerance_;
+
+	tolerances_reason_ = reason.str();
+	std::cout << "   - automatic tolerances: " << tolerances_reason_ << std::endl;
+}
+
+void Respecth2OpenSMOKEpp::WriteTolerancesOnASCII(std::ofstream& fOut)
+{
+	if (tolerances_reason_.size() != 0)
+		fOut << "// Automatic tolerances: " << tolerances_reason_ << std::endl;
+
+	WriteODEParametersOnASCII("ode-parameters", fOut, preset_.abs_tolerance_, preset_.rel_tolerance_);
+}
+
+void Respecth2OpenSMOKEpp::DefineOutputSpecies()
+{
+	output_species_.clear();
+
+	// Species in the initial (inlet) compositions
+	for (unsigned int i = 0; i < initial_compositions_.size(); i++)
+		for (unsigned int j = 0; j < initial_compositions_[i].names().size(); j++)
+			AddOutputSpecies(initial_compositions_[i].names()[j], "", "");
+
+	// Target of ignition delay measurements
+	if (idt_.target_ != "" && idt_.target_ != "T" && idt_.target_ != "p")
+		AddOutputSpecies(idt_.target_, "", "");
+
+	// Measured species (all the dataGroups)
+	BOOST_FOREACH(boost::property_tree::ptree::value_type const& node, ptree_.get_child("experiment"))
+	{
+		if (node.first != "dataGroup")
+			continue;
+
+		BOOST_FOREACH(boost::property_tree::ptree::value_type const& property, node.second)
+		{
+			if (property.first != "property")
+				continue;
+
+			const std::string name = property.second.get<std::string>("<xmlattr>.name", "");
+			if (name == "composition" || name == "concentration")
+			{
+				AddOutputSpecies(	property.second.get<std::string>("speciesLink.<xmlattr>.preferredKey", ""),
+									property.second.get<std::string>("speciesLink.<xmlattr>.chemName", ""),
+									property.second.get<std::string>("speciesLink.<xmlattr>.CAS", ""));
+			}
+		}
+	}
+
+	std::cout << "   - output species: " << output_species_.size() << std::endl;
+}
+
+void Respecth2OpenSMOKEpp::AddOutputSpecies(const std::string name, const std::string name_chem, const std::string CAS)
+{
+	std::string species = name;
+
+	// Name from the database of species (CAS first, then chemical name)
+	if (database_species_.is_active())
+	{
+		std::vector<std::string>::const_iterator it = std::find(database_species_.CAS().begin(), database_species_.CAS().end(), CAS);
+		if (CAS != "" && it != database_species_.CAS().end())
+			species = database_species_.names()[std::distance(database_species_.CAS().begin(), it)];
+		else
+		{
+			it = std::find(database_species_.chem_names().begin(), database_species_.chem_names().end(), name_chem);
+			if (name_chem != "" && it != database_species_.chem_names().end())
+				species = database_species_.names()[std::distance(database_species_.chem_names().begin(), it)];
+		}
+	}
+
+	// Name in the kinetic mechanism
+	std::vector<std::string>::const_iterator it = species_in_kinetic_mech_.end();
+	if (case_sensitive_ == true)
+		it = std::find(species_in_kinetic_mech_.begin(), species_in_kinetic_mech_.end(), species);
+	else
+		it = std::find_if(species_in_kinetic_mech_.begin(), species_in_kinetic_mech_.end(),
+			[&species](const std::string& s) { return boost::iequals(s, species); });
+
+	if (it == species_in_kinetic_mech_.end())
+	{
+		std::cout << "   - output species " << species << " is not available in the kinetic mechanism (skipped)" << std::endl;
+		return;
+	}
+
+	if (std::find(output_species_.begin(), output_species_.end(), *it) == output_species_.end())
+		output_species_.push_back(*it);
 }
 
 void Respecth2OpenSMOKEpp::WriteHeaderText(std::ofstream& fOut)
@@ -145,6 +858,29 @@ void Respecth2OpenSMOKEpp::WriteHeaderText(std::ofstream& fOut)
 void Respecth2OpenSMOKEpp::WriteMetaData(std::ofstream& fOut)
 {
 	bibliography_.WriteOnASCII(fOut);
+
+	// Position of the dataPoints of each source file in the coalesced parametric analysis
+	if (sources_.size() != 0)
+	{
+		fOut << "// Coalesced experiments" << std::endl;
+		std::size_t first = 1;
+		for (unsigned int k = 0; k < sources_.size(); k++)
+		{
+			fOut << "// DataPoints " << first << "-" << first + sources_[k].second - 1 << ": " << sources_[k].first << std::endl;
+			first += sources_[k].second;
+		}
+		fOut << std::endl;
+	}
+
+	if (points_.size() != 0)
+	{
+		fOut << "// DataPoints" << std::endl;
+		fOut << "// Indices:     ";
+		for (unsigned int i = 0; i < points_.size(); i++)
+			fOut << points_[i] + 1 << " ";
+		fOut << std::endl;
+		fOut << std::endl;
+	}
 }
 
 void Respecth2OpenSMOKEpp::ErrorMessage(const std::string message)
@@ -215,12 +951,12 @@ void Respecth2OpenSMOKEpp::ReadIdtTypeFromXML()
 		}
 		else if (idt_.units_ == "ppm")
 		{
-			idt_.amount_ *= 1.e6;
+			idt_.amount_ *= 1.e-6;
 			idt_.units_ = "mole fraction";
 		}
 		else if (idt_.units_ == "ppb")
 		{
-			idt_.amount_ *= 1.e9;
+			idt_.amount_ *= 1.e-9;
 			idt_.units_ = "mole fraction";
 		}
 		else if (idt_.units_ == "mol/cm3")
@@ -261,6 +997,8 @@ void Respecth2OpenSMOKEpp::ReadIdtTypeFromXML()
 
 void Respecth2OpenSMOKEpp::ReadConstantValueFromXML()
 {
+	ScopedStageTimer timer("constant properties");
+
 	// Recognize the available data
 	constant_temperature_ = false;
 	constant_pressure_ = false;
@@ -59,7 +59,10 @@ public:
 							const boost::filesystem::path output_folder,
 							const std::vector<std::string> species_in_kinetic_mech,
 							const bool case_sensitive,
-							DatabaseSpecies& database_species);
+							DatabaseSpecies& database_species,
+							const ConversionSettings& settings);
+
+	virtual ~Respecth2OpenSMOKEpp() {};
 
 	void ReadConstantValueFromXML();
 
@@ -67,6 +70,20 @@ public:
 
 	void WriteOnASCIIFile(boost::filesystem::path file_name);
 
+	// Key of the experiments which can be coalesced in a single dictionary (empty: the experiment cannot be coalesced)
+	virtual std::string CoalescingKey() const { return ""; };
+
+	// Appends the dataPoints of an experiment with the same key
+	virtual void Coalesce(const Respecth2OpenSMOKEpp& other);
+
+	// Dictionary <name>.dic (and output folder <name>) of coalesced experiments
+	void WriteCoalescedOnASCIIFile(const std::string& name);
+
+	// Drops the parts of the XML tree not needed to write the dictionary (experiments kept in memory)
+	void CompactXMLTree();
+
+	const std::string& experiment_type() const { return experiment_type_; }
+
 	void ErrorMessage(const std::string message);
 
 protected:
@@ -141,11 +158,100 @@ protected:
 	// Database of species names
 	DatabaseSpecies& database_species_;
 
+	// Conversion settings (from the main dictionary)
+	ConversionSettings settings_;
+
+	// Solver settings of the selected fidelity
+	FidelityPreset preset_;
+
+	// Reason of the automatic selection of tolerances (empty: tolerances of the preset)
+	std::string tolerances_reason_;
+
+	// ode-parameters dictionary needed by reactors (not by ignition delays, which always write it)
+	bool OdeParametersRequired() const;
+
+	void WriteTolerancesOnASCII(std::ofstream& fOut);
+
+	// Groups of dataPoints written in separate dictionaries (none: a single dictionary)
+	std::vector< std::vector<unsigned int> > groups_;
+
+	// dataPoints of the dictionary being written (empty: all the dataPoints)
+	std::vector<unsigned int> points_;
+
+	// Species written on file by the solvers (empty: all the species)
+	std::vector<std::string> output_species_;
+
+	// Source files of coalesced experiments and their number of dataPoints (empty: no coalescing)
+	std::vector< std::pair<std::string, std::size_t> > sources_;
+
+	// Constant conditions which must be the same in coalesced experiments
+	std::string KeyOfCommonConditions() const;
+
+	// Values of the dataPoints of the dictionary being written (constant values are not affected)
+	template<typename T>
+	std::vector<T> SelectPoints(const std::vector<T>& values) const
+	{
+		if (points_.size() == 0 || values.size() <= 1)
+			return values;
+
+		std::vector<T> selected(points_.size());
+		for (unsigned int i = 0; i < points_.size(); i++)
+			selected[i] = values[points_[i]];
+		return selected;
+	}
+
+	// Groups of dataPoints whose values differ at most by the given ratio (sorted by increasing values)
+	std::vector< std::vector<unsigned int> > BucketsOfPoints(const std::vector<double>& values, const double ratio) const;
+
+	// Conditions of the dataPoints used to reorder them (one vector for each variable, constant variables have a single value)
+	virtual std::vector< std::vector<double> > CoordinatesOfPoints() const;
+
+	// Number of dataPoints in the dictionary being written
+	std::size_t NumberOfPoints() const;
+
+	// Estimated cost of a single integration of a 0D reactor up to the given end time (in s, 0: unknown) through
+	// a profile with the given number of points, and of a single 1D flame on a grid with the given number of points (arbitrary units)
+	double CostOfReactor(const double end_time = 0., const std::size_t profile_points = 0) const;
+	double CostOfFlame(const int grid_points) const;
+
+	// Steps between two outputs on file so that a few outputs fall between any two consecutive measured
+	// times (in s), with the steps per decade of time of the cost model (1: every step)
+	int StepsBetweenSamples(const std::vector<double>& times) const;
+
+	// Estimated cost of the simulations in the dictionary being written (one reactor for each dataPoint by default)
+	virtual double EstimatedCost() const;
+
+	// Files (other than the kinetic mechanism) read by the solver of the dictionary being written
+	virtual std::vector<boost::filesystem::path> InputFiles() const { return std::vector<boost::filesystem::path>(); };
+
+	// Canonical key of the conditions of a dataPoint (empty: the dataPoints of the experiment are never shared)
+	virtual std::string KeyOfPoint(const unsigned int i) const { return ""; };
+
+	// Key of the conditions common to all the experiments: solver, temperature, pressure, composition, output species and tolerances
+	std::string KeyOfConditions(const unsigned int i) const;
+
+	// Value of a dataPoint in SI units, rounded to the significant digits of the deduplication tolerance
+	std::string CanonicalValue(const std::vector<double>& values, const std::string& units, const unsigned int i) const;
+
 private:
 
+	void WriteDictionary(const boost::filesystem::path& file_name);
 	void WriteHeaderText(std::ofstream& fOut);
 	void WriteMetaData(std::ofstream& fOut);
 
+	void DefineOutputSpecies();
+	void SelectTolerances();
+	void ReorderPoints();
+	void SplitGroupsOfPoints(const std::size_t max_points);
+	bool RemoveSharedPoints();
+	std::vector<unsigned int> NearestNeighbourPath(const std::vector<unsigned int>& points, const std::vector< std::vector<double> >& coordinates) const;
+	void AddOutputSpecies(const std::string name, const std::string name_chem, const std::string CAS);
+
+	virtual void DefineGroupsOfPoints() {};
+
+	// OpenSMOKE++ solver which runs the dictionary being written
+	virtual std::string Solver() const = 0;
+
 	virtual void WriteSimulationData(std::ofstream& fOut) = 0;
 
 	virtual void WriteAdditionalFiles() = 0;
@@ -36,6 +36,8 @@
 
 #include "Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation.h"
 #include "Utilities.h"
+#include <algorithm>
+#include <cmath>
 
 Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation
 (const boost::filesystem::path file_name,
@@ -43,8 +45,9 @@ Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::Respecth2OpenSMOKEpp_Burne
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -75,11 +78,20 @@ Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::Respecth2OpenSMOKEpp_Burne
 	std::cout << " * Reading dataGroup section (temperature)..." << std::endl;
 	ReadNonConstantValueFromXML(ptree_, "temperature", t_profile_values_, t_profile_units_);
 
+	// Sampling positions (before any manipulation of the profiles)
+	x_sampling_values_ = x_profile_values_;
+	std::sort(x_sampling_values_.begin(), x_sampling_values_.end());
+	x_sampling_values_.erase(std::unique(x_sampling_values_.begin(), x_sampling_values_.end()), x_sampling_values_.end());
+
 	// Recognize if the temperature profile is fixed or not
 	fixed_temperature_profile_ = true;
 	if (t_profile_values_.size() == 0)
 		fixed_temperature_profile_ = false;
 
+	// Monotonic distance and (optional) decimation of the temperature profile
+	if (fixed_temperature_profile_ == true)
+		ConditionProfiles(x_profile_values_, t_profile_values_, settings_.profile_decimation_tolerance_);
+
 	// Check for first point
 	if (fixed_temperature_profile_ == true)
 	{
@@ -116,20 +128,7 @@ void Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::WriteSimulationData(s
 
 	WriteMixStatusOnASCII("inlet-stream", fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
 
-	fOut << "Dictionary grid" << std::endl;
-	fOut << "{" << std::endl;
-	if (fixed_temperature_profile_ == true)
-		fOut << "        @Length                " << x_profile_values_.back() << " " << x_profile_units_ << " ;" << std::endl;
-	else
-		fOut << "        @Length                10 cm;" << std::endl;
-	fOut << "        @InitialPoints			12;" << std::endl;
-	fOut << "        @Type					database;" << std::endl;
-	fOut << "        @MaxPoints				400;" << std::endl;
-	fOut << "        @MaxAdaptivePoints		15;" << std::endl;
-	fOut << "        @GradientCoefficient	0.05;" << std::endl;
-	fOut << "        @CurvatureCoefficient	0.5;" << std::endl;
-	fOut << "}" << std::endl;
-	fOut << std::endl;
+	WriteGridOnASCII(fOut);
 
 	if (fixed_temperature_profile_ == true)
 	{
@@ -148,3 +147,72 @@ void Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::WriteSimulationData(s
 
 	fOut << std::endl;
 }
+
+double Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::EstimatedCost() const
+{
+	// A single flame, sampled at all the measured positions
+	double length = 0.;
+	int initial_points = preset_.grid_initial_points_;
+	int max_points = preset_.grid_max_points_;
+	PlannedGrid(length, initial_points, max_points);
+
+	return CostOfFlame(max_points);
+}
+
+bool Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::PlannedGrid(double& length, int& initial_points, int& max_points) const
+{
+	if (settings_.plan_flame_grid_ == false || x_sampling_values_.size() <= 1)
+		return false;
+
+	// The grid resolves the closest sampling positions, up to the farthest one
+	double dx_min = x_sampling_values_.back() - x_sampling_values_.front();
+	for (unsigned int i = 1; i < x_sampling_values_.size(); i++)
+		dx_min = std::min(dx_min, x_sampling_values_[i] - x_sampling_values_[i - 1]);
+
+	// Without an imposed temperature profile, some room is left for the post-flame region
+	length = 1.25 * x_sampling_values_.back();
+	if (fixed_temperature_profile_ == true)
+		length = std::max(x_sampling_values_.back(), x_profile_values_.back());
+
+	// Bounds scale with the grid of the fidelity preset (40 initial points and at least 60 points for the reference one)
+	const int max_initial_points = std::max(preset_.grid_initial_points_, preset_.grid_max_points_ / 10);
+	const int min_max_points = std::max(max_initial_points, (3 * preset_.grid_max_points_) / 20);
+
+	initial_points = std::min(max_initial_points, std::max(preset_.grid_initial_points_, static_cast<int>(x_sampling_values_.size())));
+	max_points = std::min(preset_.grid_max_points_, std::max(min_max_points, static_cast<int>(std::ceil(4. * length / dx_min))));
+
+	return true;
+}
+
+void Respecth2OpenSMOKEpp_BurnerStabilizedFlameSpeciation::WriteGridOnASCII(std::ofstream& fOut)
+{
+	fOut << "Dictionary grid" << std::endl;
+	fOut << "{" << std::endl;
+
+	double length = 0.;
+	int initial_points = 0;
+	int max_points = 0;
+	if (PlannedGrid(length, initial_points, max_points) == true)
+	{
+		fOut << "        @Length                " << length << " " << x_profile_units_ << " ;" << std::endl;
+		fOut << "        @InitialPoints			" << initial_points << ";" << std::endl;
+		fOut << "        @Type					database;" << std::endl;
+		fOut << "        @MaxPoints				" << max_points << ";" << std::endl;
+	}
+	else
+	{
+		if (fixed_temperature_profile_ == true)
+			fOut << "        @Length                " << x_profile_values_.back() << " " << x_profile_units_ << " ;" << std::endl;
+		else
+			fOut << "        @Length                10 cm;" << std::endl;
+		fOut << "        @InitialPoints			" << preset_.grid_initial_points_ << ";" << std::endl;
+		fOut << "        @Type					database;" << std::endl;
+		fOut << "        @MaxPoints				" << preset_.grid_max_points_ << ";" << std::endl;
+	}
+
+	fOut << "        @MaxAdaptivePoints		" << preset_.grid_max_adaptive_points_ << ";" << std::endl;
+	fOut << "        @GradientCoefficient	" << preset_.grid_gradient_coefficient_ << ";" << std::endl;
+	fOut << "        @CurvatureCoefficient	" << preset_.grid_curvature_coefficient_ << ";" << std::endl;
+	fOut << "}" << std::endl;
+	fOut << std::endl;
+}
@@ -47,7 +47,8 @@ public:
 															const boost::filesystem::path output_folder,
 															const std::vector<std::string> species_in_kinetic_mech,
 															const bool case_sensitive,
-															DatabaseSpecies& database_species);
+															DatabaseSpecies& database_species,
+															const ConversionSettings& settings);
 
 private:
 
@@ -63,6 +64,17 @@ private:
 	std::vector<double> t_profile_values_;
 	std::string t_profile_units_;
 
+	std::vector<double> x_sampling_values_;
+
+	void WriteGridOnASCII(std::ofstream& fOut);
+
+	// Length and number of points of the grid planned from the sampling positions (false: grid of the preset)
+	bool PlannedGrid(double& length, int& initial_points, int& max_points) const;
+
+	virtual double EstimatedCost() const;
+
+	virtual std::string Solver() const { return "PremixedLaminarFlame1D"; };
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles() {};
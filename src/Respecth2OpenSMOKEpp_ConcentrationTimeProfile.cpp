@@ -43,8 +43,9 @@ Respecth2OpenSMOKEpp_ConcentrationTimeProfile::Respecth2OpenSMOKEpp_Concentratio
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -66,6 +67,21 @@ Respecth2OpenSMOKEpp_ConcentrationTimeProfile::Respecth2OpenSMOKEpp_Concentratio
 	ReadNonConstantValueFromXML(ptree_, "time", time_profile_values_, time_profile_units_);
 }
 
+std::string Respecth2OpenSMOKEpp_ConcentrationTimeProfile::Solver() const
+{
+	if (apparatus_kind_ == ApparatusKind::FLOW_REACTOR)
+		return "PlugFlowReactor";
+	else if (apparatus_kind_ == ApparatusKind::SHOCK_TUBE)
+		return "ShockTubeReactor";
+	return "BatchReactor";
+}
+
+double Respecth2OpenSMOKEpp_ConcentrationTimeProfile::EstimatedCost() const
+{
+	// A single integration up to the last measured time
+	return CostOfReactor(ValueInSIUnits(time_profile_values_.back(), time_profile_units_));
+}
+
 void Respecth2OpenSMOKEpp_ConcentrationTimeProfile::WriteSimulationData(std::ofstream& fOut)
 {
 	std::cout << "   - simulation data" << std::endl;
@@ -81,6 +97,8 @@ void Respecth2OpenSMOKEpp_ConcentrationTimeProfile::WriteSimulationData(std::ofs
 		fOut << "        @ConstantPressure        true;" << std::endl;
 		fOut << "        @Velocity                10 cm/s;" << std::endl;
 		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 		fOut << "}" << std::endl;
 		fOut << std::endl;
 	}
@@ -93,6 +111,8 @@ void Respecth2OpenSMOKEpp_ConcentrationTimeProfile::WriteSimulationData(std::ofs
 		fOut << "        @ReflectedShockStatus    mix-status;" << std::endl;
 		fOut << "        @EndTime                 " << time_profile_values_.back() << " " << time_profile_units_ << ";" << std::endl;
 		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 		fOut << "}" << std::endl;
 		fOut << std::endl;
 	}
@@ -105,11 +125,25 @@ void Respecth2OpenSMOKEpp_ConcentrationTimeProfile::WriteSimulationData(std::ofs
 		fOut << "        @IninitialtStatus        mix-status;" << std::endl;
 		fOut << "        @EndTime                 " << time_profile_values_.back() << " " << time_profile_units_ << ";" << std::endl;
 		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 		fOut << "}" << std::endl;
 		fOut << std::endl;
 	}
 
 	WriteMixStatusOnASCII("mix-status", fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
 
-	WriteOutputOptionsOnASCII("output-options", fOut, true, 1000, true, 1, output_folder_simulation_);
+	// Output on file sized to the measured times (a few outputs between the closest ones), or every step
+	int steps_file = 1;
+	if (settings_.sample_measured_times_ == true)
+	{
+		std::vector<double> times(time_profile_values_.size());
+		for (unsigned int i = 0; i < time_profile_values_.size(); i++)
+			times[i] = ValueInSIUnits(time_profile_values_[i], time_profile_units_);
+		steps_file = StepsBetweenSamples(times);
+	}
+	WriteOutputOptionsOnASCII("output-options", fOut, true, preset_.Steps(1000), true, steps_file, output_folder_simulation_, output_species_);
+
+	if (OdeParametersRequired() == true)
+		WriteTolerancesOnASCII(fOut);
 }
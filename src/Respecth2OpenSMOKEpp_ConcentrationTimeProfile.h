@@ -47,7 +47,8 @@ public:
 													const boost::filesystem::path output_folder,
 													const std::vector<std::string> species_in_kinetic_mech,
 													const bool case_sensitive,
-													DatabaseSpecies& database_species);
+													DatabaseSpecies& database_species,
+													const ConversionSettings& settings);
 
 private:
 
@@ -57,6 +58,10 @@ private:
 	std::vector<double> time_profile_values_;
 	std::string time_profile_units_;
 
+	virtual std::string Solver() const;
+
+	virtual double EstimatedCost() const;
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles() {};
@@ -36,6 +36,24 @@
 
 #include "Respecth2OpenSMOKEpp_IgnitionDelay.h"
 #include "Utilities.h"
+#include "PerformanceStatistics.h"
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+namespace
+{
+	// Smallest value of the 1-2-5 series (1, 2, 5, 10, 20...) larger than or equal to the given (positive) one
+	double UpperEdgeOfSeries(const double value)
+	{
+		const double decade = std::pow(10., std::floor(std::log10(value)));
+		const double mantissa = value / decade;
+		if (mantissa <= 1.)	return decade;
+		if (mantissa <= 2.)	return 2. * decade;
+		if (mantissa <= 5.)	return 5. * decade;
+		return 10. * decade;
+	}
+}
 
 Respecth2OpenSMOKEpp_IgnitionDelay::Respecth2OpenSMOKEpp_IgnitionDelay
 (	const boost::filesystem::path file_name,
@@ -43,8 +61,9 @@ Respecth2OpenSMOKEpp_IgnitionDelay::Respecth2OpenSMOKEpp_IgnitionDelay
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -95,18 +114,118 @@ Respecth2OpenSMOKEpp_IgnitionDelay::Respecth2OpenSMOKEpp_IgnitionDelay
 	// Check for possible v-t history
 	ReadProfileFromXML(ptree_, "V-t history", "volume", v_history_values_, v_history_units_, "time", tau_history_values_, tau_history_units_ );
 
-	// Check for monoticity of profiles (if any)
+	// Monotonic time and (optional) decimation of profiles (if any)
 	for (unsigned int i = 0; i < v_history_values_.size(); i++)
-		ForceMonotonicProfiles(tau_history_values_[i], v_history_values_[i]);
+		ConditionProfiles(tau_history_values_[i], v_history_values_[i], settings_.profile_decimation_tolerance_);
 
-	// Select a suitable maximum time for integration
-	tau_max_ = *std::max_element(std::begin(tau_values_), std::end(tau_values_)) * 2;
+	// Names of V-t histories
+	PrepareProfiles();
+}
+
+std::string Respecth2OpenSMOKEpp_IgnitionDelay::Profile(const unsigned int i) const
+{
+	if (type_ == Type::VARIABLE_TP)
+		return ProfileOnCVS(
+			"temperature", t_values_[i], t_units_, "pressure", p_values_[i], p_units_,
+			"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
+	else if (type_ == Type::VARIABLE_T)
+		return ProfileOnCVS(
+			"temperature", t_values_[i], t_units_, "pressure", p_values_[0], p_units_,
+			"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
+	return ProfileOnCVS(
+		"temperature", t_values_[0], t_units_, "pressure", p_values_[i], p_units_,
+		"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
+}
+
+void Respecth2OpenSMOKEpp_IgnitionDelay::PrepareProfiles()
+{
+	list_of_profiles_.resize(v_history_units_.size());
+
+	for (unsigned int i = 0; i < v_history_units_.size(); i++)
+	{
+		// Shared profiles are named after their content (i.e. the conditioned history and the T/p header)
+		if (settings_.share_profiles_ == true)
+		{
+			list_of_profiles_[i] = "profiles";
+			list_of_profiles_[i] /= ContentHash(Profile(i)) + ".cvs";
+		}
+		else
+		{
+			list_of_profiles_[i] = file_name_xml_.stem();
+			list_of_profiles_[i] += ".";  list_of_profiles_[i] += std::to_string(i + 1); list_of_profiles_[i] += ".cvs";
+		}
+	}
+}
+
+std::string Respecth2OpenSMOKEpp_IgnitionDelay::CoalescingKey() const
+{
+	// Only temperature scans without V-t histories: their dataPoints can be listed in a single parametric analysis
+	if (type_ != Type::VARIABLE_T || v_history_units_.size() != 0)
+		return "";
+
+	std::ostringstream key;
+	key << std::setprecision(17);
+	key << KeyOfCommonConditions() << static_cast<int>(apparatus_kind_) << "|";
+	key << idt_.target_ << " " << idt_.type_ << " " << idt_.amount_ << " " << idt_.units_ << "|" << tau_units_;
+	return key.str();
+}
+
+void Respecth2OpenSMOKEpp_IgnitionDelay::Coalesce(const Respecth2OpenSMOKEpp& other)
+{
+	Respecth2OpenSMOKEpp::Coalesce(other);
+
+	// Measured delays (end time, buckets)
+	const Respecth2OpenSMOKEpp_IgnitionDelay& experiment = dynamic_cast<const Respecth2OpenSMOKEpp_IgnitionDelay&>(other);
+	tau_values_.insert(tau_values_.end(), experiment.tau_values_.begin(), experiment.tau_values_.end());
+}
+
+std::string Respecth2OpenSMOKEpp_IgnitionDelay::KeyOfPoint(const unsigned int i) const
+{
+	// The measured delay is not a condition: it only sets the end time of the integration
+	std::ostringstream key;
+	key << KeyOfConditions(i) << static_cast<int>(apparatus_kind_) << "|";
+	key << idt_.target_ << " " << idt_.type_ << " " << idt_.amount_ << " " << idt_.units_ << "|";
+	key << "dpdt=" << CanonicalValue(dpdt_values_, dpdt_units_, i) << "|";
+
+	// Points share a dictionary only if their required end times fall in the same interval of the 1-2-5 series,
+	// whose upper edge is the lower bound of the end time of deduplicated dictionaries (see EndTime)
+	const double end_time = ValueInSIUnits(tau_values_[(tau_values_.size() == 1) ? 0 : i] * settings_.end_time_factor_, tau_units_);
+	key << "end=" << UpperEdgeOfSeries(end_time) << "|";
+	if (v_history_units_.size() != 0)
+		key << "V-t=" << ((settings_.share_profiles_ == true) ? list_of_profiles_[i].stem().string() : ContentHash(Profile(i)));
+	return key.str();
+}
+
+void Respecth2OpenSMOKEpp_IgnitionDelay::DefineGroupsOfPoints()
+{
+	groups_.clear();
+
+	// One dictionary for each dataPoint
+	if (settings_.end_time_policy_ == ConversionSettings::EndTimePolicy::PER_POINT)
+	{
+		for (unsigned int i = 0; i < tau_values_.size(); i++)
+			groups_.push_back(std::vector<unsigned int>(1, i));
+	}
+
+	// One dictionary for each bucket of similar ignition delays
+	else if (settings_.end_time_policy_ == ConversionSettings::EndTimePolicy::BUCKETS)
+	{
+		groups_ = BucketsOfPoints(tau_values_, settings_.end_time_bucket_ratio_);
+	}
 }
 
 void Respecth2OpenSMOKEpp_IgnitionDelay::WriteSimulationData(std::ofstream& fOut)
 {
 	std::cout << "   - simulation data" << std::endl;
 
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+	const std::vector<boost::filesystem::path> list_of_profiles = SelectPoints(list_of_profiles_);
+
+	// Select a suitable maximum time for integration
+	const double tau_max = EndTime(tau_values);
+
 	fOut << "Dictionary BatchReactor" << std::endl;
 	fOut << "{" << std::endl;
 	fOut << "        @KineticsFolder          " << kinetics_folder_.string() << ";" << std::endl;
@@ -115,7 +234,7 @@ void Respecth2OpenSMOKEpp_IgnitionDelay::WriteSimulationData(std::ofstream& fOut
 	else
 		fOut << "        @Type                    NonIsothermal-ConstantVolume;" << std::endl;
 	fOut << "        @InitialStatus           mix-status;" << std::endl;
-	fOut << "        @EndTime                 " << tau_max_ << " " << tau_units_ << ";" << std::endl;
+	fOut << "        @EndTime                 " << tau_max << " " << tau_units_ << ";" << std::endl;
 	fOut << "        @Volume                  1 cm3;" << std::endl;
 	fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 	fOut << "        @Options                 output-options;" << std::endl;
@@ -128,38 +247,76 @@ void Respecth2OpenSMOKEpp_IgnitionDelay::WriteSimulationData(std::ofstream& fOut
 	fOut << "}" << std::endl;
 	fOut << std::endl;
 
-	WriteMixStatusOnASCII("mix-status", fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
+	WriteMixStatusOnASCII("mix-status", fOut, t_values[0], t_units_, p_values[0], p_units_, initial_compositions_[0]);
 
-	WriteODEParametersOnASCII("ode-parameters", fOut, 1e-14, 1e-7);
+	WriteTolerancesOnASCII(fOut);
 
 	if (apparatus_kind_ == ApparatusKind::RCM)
-		WriteIgnitionDelayTimesOnASCII("ignition-delay-times", fOut, true, idt_);
+		WriteIgnitionDelayTimesOnASCII("ignition-delay-times", fOut, true, idt_, preset_);
 	else
-		WriteIgnitionDelayTimesOnASCII("ignition-delay-times", fOut, false, idt_);
+		WriteIgnitionDelayTimesOnASCII("ignition-delay-times", fOut, false, idt_, preset_);
 
 	if (v_history_units_.size() == 0)
 	{
 		if (type_ == Type::VARIABLE_TP)
-			WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, t_values_, t_units_, p_values_, p_units_);
+			WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, t_values, t_units_, p_values, p_units_);
 
 		if (type_ == Type::VARIABLE_T)
-			WriteParametricAnalysisOnASCII("parametric-analysis", "temperature", fOut, t_values_, t_units_);
+			WriteParametricAnalysisOnASCII("parametric-analysis", "temperature", fOut, t_values, t_units_);
 
 		if (type_ == Type::VARIABLE_P)
-			WriteParametricAnalysisOnASCII("parametric-analysis", "pressure", fOut, p_values_, p_units_);
+			WriteParametricAnalysisOnASCII("parametric-analysis", "pressure", fOut, p_values, p_units_);
 	}
 	else
 	{
-		std::vector<boost::filesystem::path> list_of_files(v_history_units_.size());
-		for (unsigned int i = 0; i < list_of_files.size(); i++)
-		{
-			list_of_files[i] = file_name_xml_.stem();
-			list_of_files[i] += ".";  list_of_files[i] += std::to_string(i + 1); list_of_files[i] += ".cvs";
-		}
-		WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, list_of_files);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, list_of_profiles);
 	}
 
-	WriteOutputOptionsOnASCII("output-options", fOut, true, 1000, true, 5, output_folder_simulation_);
+	WriteOutputOptionsOnASCII("output-options", fOut, true, preset_.Steps(1000), true, preset_.Steps(5), output_folder_simulation_, output_species_);
+}
+
+double Respecth2OpenSMOKEpp_IgnitionDelay::EndTime(const std::vector<double>& tau_values) const
+{
+	// Global policy: the same end time for all the dictionaries of the file, whatever the selected dataPoints
+	// (@MaxPointsPerDictionary, @DeduplicatePoints)
+	const std::vector<double>& delays = (settings_.end_time_policy_ == ConversionSettings::EndTimePolicy::GLOBAL) ? tau_values_ : tau_values;
+
+	const double tau_max = *std::max_element(std::begin(delays), std::end(delays)) * settings_.end_time_factor_;
+	if (settings_.deduplicate_points_ == false || tau_max <= 0.)
+		return tau_max;
+
+	// Rounded up to the edge of its interval of the 1-2-5 series, so that the dataPoints of other files
+	// deduplicated into this dictionary (same interval, see KeyOfPoint) are integrated long enough
+	const double si = ValueInSIUnits(1., tau_units_);
+	return UpperEdgeOfSeries(tau_max * si) / si;
+}
+
+double Respecth2OpenSMOKEpp_IgnitionDelay::EstimatedCost() const
+{
+	// Every dataPoint is integrated up to the end time of the dictionary, following its V-t history (if any)
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+	const double end_time = ValueInSIUnits(EndTime(tau_values), tau_units_);
+
+	if (v_history_units_.size() == 0)
+		return NumberOfPoints() * CostOfReactor(end_time);
+
+	const std::vector< std::vector<double> > tau_history_values = SelectPoints(tau_history_values_);
+
+	double cost = 0.;
+	for (unsigned int i = 0; i < tau_history_values.size(); i++)
+		cost += CostOfReactor(end_time, tau_history_values[i].size());
+	return cost;
+}
+
+std::vector<boost::filesystem::path> Respecth2OpenSMOKEpp_IgnitionDelay::InputFiles() const
+{
+	// V-t histories of the dataPoints in the dictionary
+	const std::vector<boost::filesystem::path> list_of_profiles = SelectPoints(list_of_profiles_);
+
+	std::vector<boost::filesystem::path> input_files(list_of_profiles.size());
+	for (unsigned int i = 0; i < list_of_profiles.size(); i++)
+		input_files[i] = output_folder_ / list_of_profiles[i];
+	return input_files;
 }
 
 void Respecth2OpenSMOKEpp_IgnitionDelay::WriteAdditionalFiles()
@@ -168,23 +325,22 @@ void Respecth2OpenSMOKEpp_IgnitionDelay::WriteAdditionalFiles()
 	{
 		std::cout << "   - additional files" << std::endl;
 
-		for (unsigned int i = 0; i < v_history_units_.size(); i++)
+		if (settings_.share_profiles_ == true)
+		{
+			if (!boost::filesystem::exists(output_folder_ / "profiles"))
+				boost::filesystem::create_directories(output_folder_ / "profiles");
+
+			unsigned int n_written = 0;
+			for (unsigned int i = 0; i < list_of_profiles_.size(); i++)
+				if (WriteSharedFile(output_folder_ / list_of_profiles_[i], Profile(i)) == true)
+					n_written++;
+
+			std::cout << "     " << n_written << " new profiles, " << list_of_profiles_.size() - n_written << " shared" << std::endl;
+		}
+		else
 		{
-			boost::filesystem::path file_name_cvs = output_folder_ / file_name_xml_.stem();
-			file_name_cvs += ".";  file_name_cvs += std::to_string(i + 1); file_name_cvs += ".cvs";
-			
-			if (type_ == Type::VARIABLE_TP)
-				WriteProfileOnCVS(file_name_cvs,
-					"temperature", t_values_[i], t_units_, "pressure", p_values_[i], p_units_,
-					"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
-			else if(type_ == Type::VARIABLE_T)
-				WriteProfileOnCVS(file_name_cvs,
-					"temperature", t_values_[i], t_units_, "pressure", p_values_[0], p_units_,
-					"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
-			else if (type_ == Type::VARIABLE_P)
-				WriteProfileOnCVS(file_name_cvs,
-					"temperature", t_values_[0], t_units_, "pressure", p_values_[i], p_units_,
-					"time", tau_history_values_[i], tau_history_units_[i], "volume", v_history_values_[i], v_history_units_[i]);
+			for (unsigned int i = 0; i < list_of_profiles_.size(); i++)
+				WriteFileIfChanged(output_folder_ / list_of_profiles_[i], Profile(i));
 		}
 	}	
 }
@@ -47,21 +47,46 @@ public:
 										const boost::filesystem::path output_folder,
 										const std::vector<std::string> species_in_kinetic_mech,
 										const bool case_sensitive,
-										DatabaseSpecies& database_species);
+										DatabaseSpecies& database_species,
+										const ConversionSettings& settings);
+
+	virtual std::string CoalescingKey() const;
+
+	virtual void Coalesce(const Respecth2OpenSMOKEpp& other);
 
 private:
 
 	enum class ApparatusKind { FLOW_REACTOR, SHOCK_TUBE, RCM }	apparatus_kind_;
 	enum class Type { VARIABLE_T, VARIABLE_P, VARIABLE_TP }		type_;
 
-	double tau_max_;
-
 	std::vector<std::vector<double>> v_history_values_;
 	std::vector<std::string> v_history_units_;
 
 	std::vector<std::vector<double>> tau_history_values_;
 	std::vector<std::string> tau_history_units_;
 
+	// Names of the V-t histories (.cvs files, relative to the output folder)
+	std::vector<boost::filesystem::path> list_of_profiles_;
+
+	void PrepareProfiles();
+
+	// Content of the i-th V-t history (built when needed, not kept in memory)
+	std::string Profile(const unsigned int i) const;
+
+	virtual void DefineGroupsOfPoints();
+
+	// End time (in the units of the delays) of the integrations of the given measured delays (all the delays
+	// of the file with the global policy)
+	double EndTime(const std::vector<double>& tau_values) const;
+
+	virtual std::string Solver() const { return "BatchReactor"; };
+
+	virtual double EstimatedCost() const;
+
+	virtual std::vector<boost::filesystem::path> InputFiles() const;
+
+	virtual std::string KeyOfPoint(const unsigned int i) const;
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles();
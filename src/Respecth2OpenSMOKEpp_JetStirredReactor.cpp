@@ -37,6 +37,8 @@
 
 #include "Respecth2OpenSMOKEpp_JetStirredReactor.h"
 #include "Utilities.h"
+#include <sstream>
+#include <iomanip>
 
 Respecth2OpenSMOKEpp_JetStirredReactor::Respecth2OpenSMOKEpp_JetStirredReactor
 (	const boost::filesystem::path file_name,
@@ -44,8 +46,9 @@ Respecth2OpenSMOKEpp_JetStirredReactor::Respecth2OpenSMOKEpp_JetStirredReactor
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -109,33 +112,113 @@ Respecth2OpenSMOKEpp_JetStirredReactor::Respecth2OpenSMOKEpp_JetStirredReactor
 		ErrorMessage("Combination of constant variable (P,T,V,tau) not yet implemented!");
 }
 
+std::string Respecth2OpenSMOKEpp_JetStirredReactor::CoalescingKey() const
+{
+	// Only temperature scans: pressure, volume, residence time and composition are the same for all the dataPoints
+	if (type_ != Type::VARIABLE_T)
+		return "";
+
+	std::ostringstream key;
+	key << std::setprecision(17);
+	key << KeyOfCommonConditions();
+	for (unsigned int i = 0; i < tau_values_.size(); i++)
+		key << tau_values_[i] << " ";
+	key << tau_units_;
+	return key.str();
+}
+
+std::string Respecth2OpenSMOKEpp_JetStirredReactor::KeyOfPoint(const unsigned int i) const
+{
+	return KeyOfConditions(i) + "V=" + CanonicalValue(v_values_, v_units_, i) + "|tau=" + CanonicalValue(tau_values_, tau_units_, i);
+}
+
+void Respecth2OpenSMOKEpp_JetStirredReactor::DefineGroupsOfPoints()
+{
+	groups_.clear();
+
+	// The end time depends on the dataPoints only if derived from variable residence times
+	if (type_ != Type::VARIABLE_TAU || settings_.residence_time_factor_ == 0.)
+		return;
+
+	// One dictionary for each dataPoint
+	if (settings_.end_time_policy_ == ConversionSettings::EndTimePolicy::PER_POINT)
+	{
+		for (unsigned int i = 0; i < tau_values_.size(); i++)
+			groups_.push_back(std::vector<unsigned int>(1, i));
+	}
+
+	// One dictionary for each bucket of similar residence times
+	else if (settings_.end_time_policy_ == ConversionSettings::EndTimePolicy::BUCKETS)
+	{
+		groups_ = BucketsOfPoints(tau_values_, settings_.end_time_bucket_ratio_);
+	}
+}
+
+std::vector< std::vector<double> > Respecth2OpenSMOKEpp_JetStirredReactor::CoordinatesOfPoints() const
+{
+	std::vector< std::vector<double> > coordinates = Respecth2OpenSMOKEpp::CoordinatesOfPoints();
+	coordinates.push_back(v_values_);
+	coordinates.push_back(tau_values_);
+	return coordinates;
+}
+
+double Respecth2OpenSMOKEpp_JetStirredReactor::EstimatedCost() const
+{
+	// Every dataPoint is integrated up to the end time of the dictionary (see WriteSimulationData)
+	double end_time = 5.;
+	if (settings_.residence_time_factor_ != 0.)
+	{
+		const std::vector<double> tau_values = SelectPoints(tau_values_);
+		end_time = ValueInSIUnits(*std::max_element(std::begin(tau_values), std::end(tau_values)) * settings_.residence_time_factor_, tau_units_);
+	}
+
+	return NumberOfPoints() * CostOfReactor(end_time);
+}
+
 void Respecth2OpenSMOKEpp_JetStirredReactor::WriteSimulationData(std::ofstream& fOut)
 {
 	std::cout << "   - simulation data" << std::endl;
 
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	const std::vector<double> v_values = SelectPoints(v_values_);
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+
+	// Select a suitable end time: fixed (default) or a multiple of the (largest) residence time
+	std::ostringstream end_time;
+	if (settings_.residence_time_factor_ == 0.)
+		end_time << "5" << " " << "s";
+	else
+		end_time << *std::max_element(std::begin(tau_values), std::end(tau_values)) * settings_.residence_time_factor_ << " " << tau_units_;
+
 	fOut << "Dictionary PerfectlyStirredReactor" << std::endl;
 	fOut << "{" << std::endl;
 	fOut << "        @KineticsFolder      " << kinetics_folder_.string() << ";" << std::endl;
 	fOut << "        @Type                Isothermal-ConstantPressure;" << std::endl;
 	fOut << "        @InletStatus         inlet-status;" << std::endl;
-	fOut << "        @ResidenceTime       " << tau_values_[0] << " " << tau_units_ << " ;" << std::endl;
-	fOut << "        @Volume              " << v_values_[0] << " " << v_units_ << " ;" << std::endl;
-	fOut << "        @EndTime             " << "5" << " " << "s" << " ;" << std::endl;
+	fOut << "        @ResidenceTime       " << tau_values[0] << " " << tau_units_ << " ;" << std::endl;
+	fOut << "        @Volume              " << v_values[0] << " " << v_units_ << " ;" << std::endl;
+	fOut << "        @EndTime             " << end_time.str() << " ;" << std::endl;
 	fOut << "        @Options             output-options;" << std::endl;
+	if (OdeParametersRequired() == true)
+		fOut << "        @OdeParameters       ode-parameters;" << std::endl;
 	fOut << "        @ParametricAnalysis  parametric-analysis;" << std::endl;
 	fOut << "}" << std::endl;
 	fOut << std::endl;
 
-	WriteMixStatusOnASCII("inlet-status", fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
+	WriteMixStatusOnASCII("inlet-status", fOut, t_values[0], t_units_, p_values[0], p_units_, initial_compositions_[0]);
 
 	if (type_ == Type::VARIABLE_T)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "temperature", fOut, t_values_, t_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "temperature", fOut, t_values, t_units_);
 	else if (type_ == Type::VARIABLE_P)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "pressure", fOut, p_values_, p_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "pressure", fOut, p_values, p_units_);
 	else if (type_ == Type::VARIABLE_V)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "volume", fOut, v_values_, v_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "volume", fOut, v_values, v_units_);
 	else if (type_ == Type::VARIABLE_TAU)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "time", fOut, tau_values_, tau_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "time", fOut, tau_values, tau_units_);
+
+	WriteOutputOptionsOnASCII("output-options", fOut, true, preset_.Steps(1000), true, preset_.Steps(5000), output_folder_simulation_, output_species_);
 
-	WriteOutputOptionsOnASCII("output-options", fOut, true, 1000, true, 5000, output_folder_simulation_);
+	if (OdeParametersRequired() == true)
+		WriteTolerancesOnASCII(fOut);
 } 
@@ -47,7 +47,10 @@ public:
 											const boost::filesystem::path output_folder,
 											const std::vector<std::string> species_in_kinetic_mech,
 											const bool case_sensitive,
-											DatabaseSpecies& database_species);
+											DatabaseSpecies& database_species,
+											const ConversionSettings& settings);
+
+	virtual std::string CoalescingKey() const;
 
 private:
 
@@ -55,6 +58,16 @@ private:
 	enum class Type {	VARIABLE_T, VARIABLE_P, VARIABLE_V, 
 						VARIABLE_TAU, VARIABLE_COMPOSITION }	type_;
 
+	virtual void DefineGroupsOfPoints();
+
+	virtual std::vector< std::vector<double> > CoordinatesOfPoints() const;
+
+	virtual double EstimatedCost() const;
+
+	virtual std::string Solver() const { return "PerfectlyStirredReactor"; };
+
+	virtual std::string KeyOfPoint(const unsigned int i) const;
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles() {};
@@ -36,6 +36,7 @@
 
 #include "Respecth2OpenSMOKEpp_LaminarBurningVelocity.h"
 #include "Utilities.h"
+#include <sstream>
 
 Respecth2OpenSMOKEpp_LaminarBurningVelocity::Respecth2OpenSMOKEpp_LaminarBurningVelocity
 (	const boost::filesystem::path file_name,
@@ -43,8 +44,9 @@ Respecth2OpenSMOKEpp_LaminarBurningVelocity::Respecth2OpenSMOKEpp_LaminarBurning
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -82,6 +84,10 @@ Respecth2OpenSMOKEpp_LaminarBurningVelocity::Respecth2OpenSMOKEpp_LaminarBurning
 	if (constant_composition_ == false)
 		ReadNonConstantValueFromXML(ptree_, "composition", initial_compositions_, species_in_kinetic_mech_, case_sensitive_, database_species_);
 
+	// Measured laminar burning velocities (initial guess)
+	if (settings_.seed_flame_speed_ == true && constant_laminarburningvelocity_ == false)
+		ReadNonConstantValueFromXML(ptree_, "laminar burning velocity", sl_values_, sl_units_);
+
 	// Number of simulations
 	{
 		const unsigned int ns = static_cast<unsigned int>( std::max(p_values_.size(), std::max(t_values_.size(), initial_compositions_.size())) );
@@ -92,21 +98,65 @@ Respecth2OpenSMOKEpp_LaminarBurningVelocity::Respecth2OpenSMOKEpp_LaminarBurning
 	}
 }
 
+void Respecth2OpenSMOKEpp_LaminarBurningVelocity::DefineGroupsOfPoints()
+{
+	groups_.clear();
+
+	// One dictionary for each bucket of similar burning velocities
+	if (settings_.seed_flame_speed_ == true && sl_values_.size() > 1)
+		groups_ = BucketsOfPoints(sl_values_, settings_.flame_speed_bucket_ratio_);
+}
+
+double Respecth2OpenSMOKEpp_LaminarBurningVelocity::EstimatedCost() const
+{
+	// One freely propagating flame for each dataPoint, on the grid of the preset
+	return NumberOfPoints() * CostOfFlame(preset_.grid_max_points_);
+}
+
 void Respecth2OpenSMOKEpp_LaminarBurningVelocity::WriteSimulationData(std::ofstream& fOut)
 {
 	std::cout << "   - simulation data" << std::endl;
 
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	const std::vector<Composition> initial_compositions = SelectPoints(initial_compositions_);
+	const std::vector<std::string> list_inlet_dicts = SelectPoints(list_inlet_dicts_);
+
+	// Initial velocity and domain length (the flame thickness scales with the inverse of the burning velocity)
+	std::string inlet_velocity = "50 cm/s";
+	std::string length = "5 cm";
+	if (settings_.seed_flame_speed_ == true && sl_values_.size() != 0)
+	{
+		// Non-positive measured values (e.g. no flame) cannot seed the inlet velocity: the default one is kept
+		std::vector<double> sl_values = SelectPoints(sl_values_);
+		sl_values.erase(std::remove_if(sl_values.begin(), sl_values.end(), [](const double value) { return value <= 0.; }), sl_values.end());
+
+		const double sl = (sl_values.size() != 0) ? std::accumulate(sl_values.begin(), sl_values.end(), 0.) / static_cast<double>(sl_values.size()) : 0.;
+		const double sl_cm_s = ValueInSIUnits(sl, sl_units_) * 100.;
+
+		if (sl > 0.)
+		{
+			std::ostringstream velocity_stream;
+			velocity_stream << sl << " " << sl_units_;
+			inlet_velocity = velocity_stream.str();
+
+			std::ostringstream length_stream;
+			length_stream << std::min(20., std::max(1., 5. * 50. / sl_cm_s)) << " cm";
+			length = length_stream.str();
+		}
+	}
+
 	fOut << "Dictionary PremixedLaminarFlame1D" << std::endl;
 	fOut << "{" << std::endl;
 	fOut << "        @KineticsFolder      " << kinetics_folder_.string() << ";" << std::endl;
 	fOut << "        @Type                FlameSpeed;" << std::endl;
 
 	fOut << "        @InletStream         ";
-	for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-		fOut << list_inlet_dicts_[i] << " ";
+	for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+		fOut << list_inlet_dicts[i] << " ";
 	fOut << ";" << std::endl;
 
-	fOut << "        @InletVelocity       50 cm/s;" << std::endl;
+	fOut << "        @InletVelocity       " << inlet_velocity << ";" << std::endl;
 	fOut << "        @Grid                grid;" << std::endl;
 	fOut << "        @Output              " << output_folder_simulation_.string() << ";" << std::endl;
 	fOut << "        @UseDaeSolver        true;" << std::endl;
@@ -114,34 +164,34 @@ void Respecth2OpenSMOKEpp_LaminarBurningVelocity::WriteSimulationData(std::ofstr
 	fOut << std::endl;
 
 	if (type_ == Type::VARIABLE_T)
-		for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-			WriteMixStatusOnASCII(list_inlet_dicts_[i], fOut, t_values_[i], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
+		for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+			WriteMixStatusOnASCII(list_inlet_dicts[i], fOut, t_values[i], t_units_, p_values[0], p_units_, initial_compositions[0]);
 
 	if (type_ == Type::VARIABLE_P)
-		for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-			WriteMixStatusOnASCII(list_inlet_dicts_[i], fOut, t_values_[0], t_units_, p_values_[i], p_units_, initial_compositions_[0]);
+		for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+			WriteMixStatusOnASCII(list_inlet_dicts[i], fOut, t_values[0], t_units_, p_values[i], p_units_, initial_compositions[0]);
 
 	if (type_ == Type::VARIABLE_COMPOSITION)
-		for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-			WriteMixStatusOnASCII(list_inlet_dicts_[i], fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[i]);
+		for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+			WriteMixStatusOnASCII(list_inlet_dicts[i], fOut, t_values[0], t_units_, p_values[0], p_units_, initial_compositions[i]);
 
 	if (type_ == Type::VARIABLE_T_COMPOSITION)
-		for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-			WriteMixStatusOnASCII(list_inlet_dicts_[i], fOut, t_values_[i], t_units_, p_values_[0], p_units_, initial_compositions_[i]);
+		for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+			WriteMixStatusOnASCII(list_inlet_dicts[i], fOut, t_values[i], t_units_, p_values[0], p_units_, initial_compositions[i]);
 
 	if (type_ == Type::VARIABLE_P_COMPOSITION)
-		for (unsigned int i = 0; i < list_inlet_dicts_.size(); i++)
-			WriteMixStatusOnASCII(list_inlet_dicts_[i], fOut, t_values_[0], t_units_, p_values_[i], p_units_, initial_compositions_[i]);
+		for (unsigned int i = 0; i < list_inlet_dicts.size(); i++)
+			WriteMixStatusOnASCII(list_inlet_dicts[i], fOut, t_values[0], t_units_, p_values[i], p_units_, initial_compositions[i]);
 
 	fOut << "Dictionary grid" << std::endl;
 	fOut << "{" << std::endl;
-	fOut << "        @Length                5 cm;" << std::endl;
-	fOut << "        @InitialPoints         12;" << std::endl;
+	fOut << "        @Length                " << length << ";" << std::endl;
+	fOut << "        @InitialPoints         " << preset_.grid_initial_points_ << ";" << std::endl;
 	fOut << "        @Type                  database;" << std::endl;
-	fOut << "        @MaxPoints             400;" << std::endl;
-	fOut << "        @MaxAdaptivePoints     15;" << std::endl;
-	fOut << "        @GradientCoefficient   0.05;" << std::endl;
-	fOut << "        @CurvatureCoefficient  0.5;" << std::endl;
+	fOut << "        @MaxPoints             " << preset_.grid_max_points_ << ";" << std::endl;
+	fOut << "        @MaxAdaptivePoints     " << preset_.grid_max_adaptive_points_ << ";" << std::endl;
+	fOut << "        @GradientCoefficient   " << preset_.grid_gradient_coefficient_ << ";" << std::endl;
+	fOut << "        @CurvatureCoefficient  " << preset_.grid_curvature_coefficient_ << ";" << std::endl;
 	fOut << "}" << std::endl;
 	fOut << std::endl;
 }
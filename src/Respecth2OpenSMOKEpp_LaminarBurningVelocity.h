@@ -47,7 +47,8 @@ public:
 												const boost::filesystem::path output_folder,
 												const std::vector<std::string> species_in_kinetic_mech,
 												const bool case_sensitive,
-												DatabaseSpecies& database_species);
+												DatabaseSpecies& database_species,
+												const ConversionSettings& settings);
 
 private:
 
@@ -57,6 +58,15 @@ private:
 
 	std::vector<std::string> list_inlet_dicts_;
 
+	virtual void DefineGroupsOfPoints();
+
+	virtual double EstimatedCost() const;
+
+	virtual std::string Solver() const { return "PremixedLaminarFlame1D"; };
+
+	// The measured burning velocity is not a condition: it only seeds the initial guess of the flame
+	virtual std::string KeyOfPoint(const unsigned int i) const { return KeyOfConditions(i); };
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles() {};
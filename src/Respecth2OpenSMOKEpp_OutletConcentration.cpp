@@ -36,6 +36,9 @@
 
 #include "Respecth2OpenSMOKEpp_OutletConcentration.h"
 #include "Utilities.h"
+#include <algorithm>
+#include <map>
+#include <functional>
 
 Respecth2OpenSMOKEpp_OutletConcentration::Respecth2OpenSMOKEpp_OutletConcentration
 (	const boost::filesystem::path file_name,
@@ -43,8 +46,9 @@ Respecth2OpenSMOKEpp_OutletConcentration::Respecth2OpenSMOKEpp_OutletConcentrati
 	const boost::filesystem::path output_folder,
 	const std::vector<std::string> species_in_kinetic_mech,
 	const bool case_sensitive,
-	DatabaseSpecies& database_species) :
-	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species)
+	DatabaseSpecies& database_species,
+	const ConversionSettings& settings) :
+	Respecth2OpenSMOKEpp(file_name, kinetics_folder, output_folder, species_in_kinetic_mech, case_sensitive, database_species, settings)
 {
 	// Recognize the apparatus kind
 	const std::string apparatus_kind = ptree_.get<std::string>("experiment.apparatus.kind", "unspecified");
@@ -87,10 +91,102 @@ Respecth2OpenSMOKEpp_OutletConcentration::Respecth2OpenSMOKEpp_OutletConcentrati
 	}
 }
 
+void Respecth2OpenSMOKEpp_OutletConcentration::DefineGroupsOfPoints()
+{
+	groups_.clear();
+
+	if (settings_.merge_residence_times_ == false)
+		return;
+
+	// One dictionary for each group of dataPoints with the same temperature and pressure (the composition is constant)
+	std::vector< std::vector<unsigned int> > groups;
+	std::map<std::pair<double, double>, unsigned int> conditions;
+	for (unsigned int i = 0; i < tau_values_.size(); i++)
+	{
+		const double t = (t_values_.size() == 1) ? t_values_[0] : t_values_[i];
+		const double p = (p_values_.size() == 1) ? p_values_[0] : p_values_[i];
+
+		const auto it = conditions.insert(std::make_pair(std::make_pair(t, p), static_cast<unsigned int>(groups.size())));
+		if (it.second == true)
+			groups.push_back(std::vector<unsigned int>());
+		groups[it.first->second].push_back(i);
+	}
+
+	// Conditions with a single residence time do not save any integration: they are kept together
+	// in a single dictionary with the usual parametric analysis
+	std::vector<unsigned int> single;
+	for (unsigned int k = 0; k < groups.size(); k++)
+	{
+		if (groups[k].size() == 1)
+			single.push_back(groups[k][0]);
+		else
+			groups_.push_back(groups[k]);
+	}
+	if (single.size() != 0)
+		groups_.push_back(single);
+}
+
+bool Respecth2OpenSMOKEpp_OutletConcentration::MergedResidenceTimes() const
+{
+	if (settings_.merge_residence_times_ == false || NumberOfPoints() < 2)
+		return false;
+
+	// Merged only if all the dataPoints of the dictionary being written have the same temperature and pressure
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	return	std::adjacent_find(t_values.begin(), t_values.end(), std::not_equal_to<double>()) == t_values.end() &&
+			std::adjacent_find(p_values.begin(), p_values.end(), std::not_equal_to<double>()) == p_values.end();
+}
+
+std::vector< std::vector<double> > Respecth2OpenSMOKEpp_OutletConcentration::CoordinatesOfPoints() const
+{
+	std::vector< std::vector<double> > coordinates = Respecth2OpenSMOKEpp::CoordinatesOfPoints();
+	coordinates.push_back(tau_values_);
+	return coordinates;
+}
+
+double Respecth2OpenSMOKEpp_OutletConcentration::EstimatedCost() const
+{
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+
+	// Merged residence times: a single integration passes through all the dataPoints of the dictionary
+	if (MergedResidenceTimes() == true)
+		return CostOfReactor(ValueInSIUnits(*std::max_element(std::begin(tau_values), std::end(tau_values)), tau_units_));
+
+	// One integration up to the residence time of each dataPoint
+	const std::size_t n = NumberOfPoints();
+	double cost = 0.;
+	for (std::size_t i = 0; i < n; i++)
+		cost += CostOfReactor(ValueInSIUnits(tau_values[(tau_values.size() == 1) ? 0 : i], tau_units_));
+	return cost;
+}
+
+std::string Respecth2OpenSMOKEpp_OutletConcentration::Solver() const
+{
+	if (apparatus_kind_ == ApparatusKind::FLOW_REACTOR)
+		return "PlugFlowReactor";
+	return "ShockTubeReactor";
+}
+
+std::string Respecth2OpenSMOKEpp_OutletConcentration::KeyOfPoint(const unsigned int i) const
+{
+	return KeyOfConditions(i) + "tau=" + CanonicalValue(tau_values_, tau_units_, i);
+}
+
 void Respecth2OpenSMOKEpp_OutletConcentration::WriteSimulationData(std::ofstream& fOut)
 {
 	std::cout << "   - simulation data" << std::endl;
 
+	if (MergedResidenceTimes() == true)
+	{
+		WriteMergedSimulationData(fOut);
+		return;
+	}
+
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+
 	if (apparatus_kind_ == ApparatusKind::FLOW_REACTOR)
 	{
 		fOut << "Dictionary PlugFlowReactor" << std::endl;
@@ -98,10 +194,12 @@ void Respecth2OpenSMOKEpp_OutletConcentration::WriteSimulationData(std::ofstream
 		fOut << "        @KineticsFolder          " << kinetics_folder_.string() << ";" << std::endl;
 		fOut << "        @Type                    NonIsothermal;" << std::endl;
 		fOut << "        @InletStatus             inlet-status;" << std::endl;
-		fOut << "        @ResidenceTime           " << tau_values_[0] << " " << tau_units_ << ";" << std::endl;
+		fOut << "        @ResidenceTime           " << tau_values[0] << " " << tau_units_ << ";" << std::endl;
 		fOut << "        @ConstantPressure        true;" << std::endl;
 		fOut << "        @Velocity                10 cm/s;" << std::endl;
 		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 		fOut << "        @ParametricAnalysis      parametric-analysis;" << std::endl;
 		fOut << "}" << std::endl;
 		fOut << std::endl;
@@ -113,20 +211,79 @@ void Respecth2OpenSMOKEpp_OutletConcentration::WriteSimulationData(std::ofstream
 		fOut << "        @KineticsFolder          " << kinetics_folder_.string() << ";" << std::endl;
 		fOut << "        @Type                    ReflectedShock;" << std::endl;
 		fOut << "        @ReflectedShockStatus    inlet-status;" << std::endl;
-		fOut << "        @EndTime                 " << tau_values_[0] << " " << tau_units_ << ";" << std::endl;
+		fOut << "        @EndTime                 " << tau_values[0] << " " << tau_units_ << ";" << std::endl;
 		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
 		fOut << "        @ParametricAnalysis      parametric-analysis;" << std::endl;
 		fOut << "}" << std::endl;
 		fOut << std::endl;
 	}
 
-	WriteMixStatusOnASCII("inlet-status", fOut, t_values_[0], t_units_, p_values_[0], p_units_, initial_compositions_[0]);
+	WriteMixStatusOnASCII("inlet-status", fOut, t_values[0], t_units_, p_values[0], p_units_, initial_compositions_[0]);
 
 	if (type_ == Type::VARIABLE_T_TAU)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "residence-time-temperature", fOut, tau_values_, tau_units_, t_values_, t_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "residence-time-temperature", fOut, tau_values, tau_units_, t_values, t_units_);
 
 	if (type_ == Type::VARIABLE_P_TAU)
-		WriteParametricAnalysisOnASCII("parametric-analysis", "residence-time-pressure", fOut, tau_values_, tau_units_, p_values_, p_units_);
+		WriteParametricAnalysisOnASCII("parametric-analysis", "residence-time-pressure", fOut, tau_values, tau_units_, p_values, p_units_);
+
+	WriteOutputOptionsOnASCII("output-options", fOut, true, preset_.Steps(1000), true, preset_.Steps(5000), output_folder_simulation_, output_species_);
+
+	if (OdeParametersRequired() == true)
+		WriteTolerancesOnASCII(fOut);
+}
+
+void Respecth2OpenSMOKEpp_OutletConcentration::WriteMergedSimulationData(std::ofstream& fOut)
+{
+	const std::vector<double> t_values = SelectPoints(t_values_);
+	const std::vector<double> p_values = SelectPoints(p_values_);
+	const std::vector<double> tau_values = SelectPoints(tau_values_);
+
+	// A single integration up to the largest residence time passes through all the measured ones
+	const double tau_max = *std::max_element(std::begin(tau_values), std::end(tau_values));
+
+	// The output is sampled densely enough to interpolate the outlet concentrations at the measured residence times
+	std::vector<double> tau_sampling(tau_values.size());
+	for (unsigned int i = 0; i < tau_values.size(); i++)
+		tau_sampling[i] = ValueInSIUnits(tau_values[i], tau_units_);
+	const int steps_file = StepsBetweenSamples(tau_sampling);
+
+	if (apparatus_kind_ == ApparatusKind::FLOW_REACTOR)
+	{
+		fOut << "Dictionary PlugFlowReactor" << std::endl;
+		fOut << "{" << std::endl;
+		fOut << "        @KineticsFolder          " << kinetics_folder_.string() << ";" << std::endl;
+		fOut << "        @Type                    NonIsothermal;" << std::endl;
+		fOut << "        @InletStatus             inlet-status;" << std::endl;
+		fOut << "        @ResidenceTime           " << tau_max << " " << tau_units_ << ";" << std::endl;
+		fOut << "        @ConstantPressure        true;" << std::endl;
+		fOut << "        @Velocity                10 cm/s;" << std::endl;
+		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
+		fOut << "}" << std::endl;
+		fOut << std::endl;
+	}
+	else if (apparatus_kind_ == ApparatusKind::SHOCK_TUBE)
+	{
+		fOut << "Dictionary ShockTubeReactor" << std::endl;
+		fOut << "{" << std::endl;
+		fOut << "        @KineticsFolder          " << kinetics_folder_.string() << ";" << std::endl;
+		fOut << "        @Type                    ReflectedShock;" << std::endl;
+		fOut << "        @ReflectedShockStatus    inlet-status;" << std::endl;
+		fOut << "        @EndTime                 " << tau_max << " " << tau_units_ << ";" << std::endl;
+		fOut << "        @Options                 output-options;" << std::endl;
+		if (OdeParametersRequired() == true)
+			fOut << "        @OdeParameters           ode-parameters;" << std::endl;
+		fOut << "}" << std::endl;
+		fOut << std::endl;
+	}
+
+	WriteMixStatusOnASCII("inlet-status", fOut, t_values[0], t_units_, p_values[0], p_units_, initial_compositions_[0]);
+
+	WriteOutputOptionsOnASCII("output-options", fOut, true, preset_.Steps(1000), true, steps_file, output_folder_simulation_, output_species_);
 
-	WriteOutputOptionsOnASCII("output-options", fOut, true, 1000, true, 5000, output_folder_simulation_);
+	if (OdeParametersRequired() == true)
+		WriteTolerancesOnASCII(fOut);
 }
@@ -47,14 +47,29 @@ public:
 												const boost::filesystem::path output_folder,
 												const std::vector<std::string> species_in_kinetic_mech,
 												const bool case_sensitive,
-												DatabaseSpecies& database_species);
+												DatabaseSpecies& database_species,
+												const ConversionSettings& settings);
 
 private:
 
 	enum class ApparatusKind { FLOW_REACTOR, SHOCK_TUBE }		apparatus_kind_;
 	enum class Type { VARIABLE_T_TAU, VARIABLE_P_TAU }		type_;
 
+	virtual void DefineGroupsOfPoints();
+
+	// Single integration up to the largest residence time for the dictionary being written
+	bool MergedResidenceTimes() const;
+
+	virtual std::vector< std::vector<double> > CoordinatesOfPoints() const;
+
+	virtual double EstimatedCost() const;
+
+	virtual std::string Solver() const;
+
+	virtual std::string KeyOfPoint(const unsigned int i) const;
+
 	virtual void WriteSimulationData(std::ofstream& fOut);
+	void WriteMergedSimulationData(std::ofstream& fOut);
 
 	virtual void WriteAdditionalFiles() {};
 };
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "SharedPoints.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+SharedPoints& SharedPoints::Instance()
+{
+	static SharedPoints instance;
+	return instance;
+}
+
+SharedPoints::Source SharedPoints::Register(const std::string& key, const Source& source)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const auto it = simulated_.insert(std::make_pair(key, source));
+	if (it.second == false)
+		shared_.push_back(std::make_pair(source, it.first->second));
+
+	return it.first->second;
+}
+
+std::size_t SharedPoints::number_of_shared_points() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return shared_.size();
+}
+
+void SharedPoints::WriteOnFile(const boost::filesystem::path& file_name) const
+{
+	std::vector< std::pair<Source, Source> > shared;
+	std::size_t n_simulated = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		shared = shared_;
+		n_simulated = simulated_.size();
+	}
+
+	// Independent of the order in which the files were converted
+	std::sort(shared.begin(), shared.end(),
+		[](const std::pair<Source, Source>& a, const std::pair<Source, Source>& b)
+		{ return (a.first.file != b.first.file) ? (a.first.file < b.first.file) : (a.first.point < b.first.point); });
+
+	std::ofstream fOut(file_name.string(), std::ios::out);
+	fOut << "# Simulated dataPoints: " << n_simulated << std::endl;
+	fOut << "# Shared dataPoints:    " << shared.size() << std::endl;
+	fOut << "# " << std::left << std::setw(38) << "File" << std::setw(10) << "DataPoint" << "   " << std::setw(40) << "Simulated in" << "DataPoint" << std::endl;
+	for (unsigned int i = 0; i < shared.size(); i++)
+	{
+		fOut << "  " << std::left << std::setw(38) << shared[i].first.file << std::setw(10) << shared[i].first.point << "-> ";
+		fOut << std::setw(40) << shared[i].second.file << shared[i].second.point << std::endl;
+	}
+	fOut.close();
+
+	std::cout << "Shared dataPoints: " << shared.size() << " (reference table: " << file_name.string() << ")" << std::endl;
+}
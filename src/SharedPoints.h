@@ -0,0 +1,78 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <boost/filesystem.hpp>
+
+// Registry of the simulated dataPoints, identified by a canonical key of their conditions (see
+// Respecth2OpenSMOKEpp::KeyOfPoint). A dataPoint whose key was already registered by another
+// experiment is not simulated again: it is listed in a reference table together with the
+// dataPoint (the first one converted, files are converted in alphabetical order of their paths)
+// whose simulation it shares.
+class SharedPoints
+{
+public:
+
+	struct Source
+	{
+		std::string file;
+		std::size_t point;							// 1-based, as in the ReSpecTh file
+	};
+
+	static SharedPoints& Instance();
+
+	// Source of the simulated dataPoint with the same key (the given source itself if the key is new)
+	Source Register(const std::string& key, const Source& source);
+
+	std::size_t number_of_shared_points() const;
+
+	// Reference table: every shared dataPoint and the simulated one
+	void WriteOnFile(const boost::filesystem::path& file_name) const;
+
+private:
+
+	SharedPoints() {};
+
+	std::map<std::string, Source> simulated_;
+	std::vector< std::pair<Source, Source> > shared_;
+	mutable std::mutex mutex_;
+};
@@ -0,0 +1,236 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#include "TraceEvents.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+
+namespace
+{
+	void FlushTraceEvents()
+	{
+		TraceEvents::Instance().Flush();
+	}
+
+	// Control characters are allowed in file names
+	std::string EscapeJSON(const std::string& text)
+	{
+		std::string escaped;
+		for (std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+		{
+			const unsigned char c = static_cast<unsigned char>(*it);
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += *it;
+			}
+			else if (c < 0x20)
+			{
+				const char* hex = "0123456789abcdef";
+				escaped += "\\u00";
+				escaped += hex[c >> 4];
+				escaped += hex[c & 0xf];
+			}
+			else
+				escaped += *it;
+		}
+		return escaped;
+	}
+}
+
+const std::size_t TraceEvents::buffer_size_;
+const std::size_t TraceEvents::file_names_size_;
+
+thread_local TraceEvents::ThreadSlot TraceEvents::thread_slot_;
+
+TraceEvents::ThreadSlot::~ThreadSlot()
+{
+	if (buffer != nullptr)
+		TraceEvents::Instance().Release(buffer);
+}
+
+TraceEvents& TraceEvents::Instance()
+{
+	static TraceEvents instance;
+	return instance;
+}
+
+TraceEvents::TraceEvents() :
+	is_active_(false)
+{
+}
+
+void TraceEvents::Open(const boost::filesystem::path& file_name)
+{
+	file_name_ = file_name;
+	start_ = std::chrono::steady_clock::now();
+	is_active_ = true;
+
+	// Flush is called by main once the scan tasks are joined; at exit, it only covers a premature
+	// exit (e.g. fatal errors), and it does nothing if the events were already written
+	std::atexit(FlushTraceEvents);
+}
+
+TraceEvents::Buffer& TraceEvents::ThreadBuffer()
+{
+	if (thread_slot_.buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (free_buffers_.empty() == false)
+		{
+			thread_slot_.buffer = free_buffers_.back();
+			free_buffers_.pop_back();
+		}
+		else
+		{
+			buffers_.push_back(std::unique_ptr<Buffer>(new Buffer));
+			buffers_.back()->events.resize(buffer_size_);
+			buffers_.back()->count = 0;
+			buffers_.back()->file_names.resize(file_names_size_);
+			buffers_.back()->file_count = 0;
+			buffers_.back()->tid = static_cast<unsigned int>(buffers_.size());
+
+			thread_slot_.buffer = buffers_.back().get();
+		}
+
+		thread_slot_.buffer->file = 0;
+	}
+
+	return *thread_slot_.buffer;
+}
+
+void TraceEvents::Release(Buffer* buffer)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	free_buffers_.push_back(buffer);
+}
+
+void TraceEvents::SetFileName(const std::string& file_name)
+{
+	if (is_active_ == false)
+		return;
+
+	Buffer& buffer = ThreadBuffer();
+	buffer.file_names[buffer.file_count % file_names_size_] = file_name;
+	buffer.file = ++buffer.file_count;
+}
+
+void TraceEvents::Record(const char* name, const char phase)
+{
+	Buffer& buffer = ThreadBuffer();
+
+	// When the buffer is full, the oldest events are overwritten
+	Event& event = buffer.events[buffer.count % buffer_size_];
+	event.name = name;
+	event.phase = phase;
+	event.file = buffer.file;
+	event.ts = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+	buffer.count++;
+}
+
+void TraceEvents::Begin(const char* name)
+{
+	Record(name, 'B');
+}
+
+void TraceEvents::End(const char* name)
+{
+	Record(name, 'E');
+}
+
+void TraceEvents::Flush()
+{
+	if (is_active_ == false)
+		return;
+
+	is_active_ = false;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::ofstream fOut(file_name_.string(), std::ios::out);
+	fOut.setf(std::ios::fixed);
+	fOut.precision(3);
+
+	fOut << "{" << std::endl;
+	fOut << "\"displayTimeUnit\": \"ms\"," << std::endl;
+	fOut << "\"traceEvents\": [" << std::endl;
+
+	bool first = true;
+	for (unsigned int k = 0; k < buffers_.size(); k++)
+	{
+		const Buffer& buffer = *buffers_[k];
+
+		fOut << (first ? "" : ",\n");
+		fOut << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.tid;
+		fOut << ",\"args\":{\"name\":\"" << ((buffer.tid == 1) ? "main" : "worker " + std::to_string(buffer.tid - 1)) << "\"}}";
+		first = false;
+
+		// When the ring wrapped, the end events of the overwritten begin events are dropped
+		const std::size_t n = std::min(buffer.count, buffer_size_);
+		std::size_t depth = 0;
+		for (std::size_t i = buffer.count - n; i < buffer.count; i++)
+		{
+			const Event& event = buffer.events[i % buffer_size_];
+			if (event.phase == 'E')
+			{
+				if (depth == 0)
+					continue;
+				depth--;
+			}
+			else
+				depth++;
+
+			// File names overwritten in their ring are not reported
+			const bool has_file_name = (event.file != 0 && event.file + file_names_size_ > buffer.file_count);
+			const std::string file_name = (has_file_name == true) ? buffer.file_names[(event.file - 1) % file_names_size_] : "";
+
+			fOut << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"stage\",\"ph\":\"" << event.phase << "\"";
+			fOut << ",\"ts\":" << event.ts << ",\"pid\":1,\"tid\":" << buffer.tid;
+			fOut << ",\"args\":{\"file\":\"" << EscapeJSON(file_name) << "\"}}";
+		}
+
+		if (buffer.count > buffer_size_)
+			std::cout << "Trace events: " << buffer.count - buffer_size_ << " events of thread " << buffer.tid << " were overwritten" << std::endl;
+	}
+
+	fOut << std::endl << "]" << std::endl;
+	fOut << "}" << std::endl;
+	fOut.close();
+}
@@ -0,0 +1,120 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <boost/filesystem.hpp>
+
+// Begin/end events of the conversion stages, exported in the Chrome trace-event format
+// (chrome://tracing, https://ui.perfetto.dev). Every thread records its events in its own
+// ring buffer, so that no lock is needed on the hot path; the buffers are flushed once the
+// recording threads are joined (Flush), or at exit after a fatal error. The buffer of a thread
+// that exits is reused by the next thread, so that their number is bounded by the number of
+// threads running at the same time (one lane of the trace for each buffer).
+class TraceEvents
+{
+public:
+
+	static TraceEvents& Instance();
+
+	void Open(const boost::filesystem::path& file_name);
+
+	bool is_active() const { return is_active_; }
+
+	void SetFileName(const std::string& file_name);
+
+	void Begin(const char* name);
+
+	void End(const char* name);
+
+	void Flush();
+
+private:
+
+	TraceEvents();
+
+	struct Event
+	{
+		const char* name;
+		double ts;
+		unsigned int file;
+		char phase;
+	};
+
+	// File names are kept in a ring as well (events refer to their sequence number, 0: none)
+	struct Buffer
+	{
+		std::vector<Event> events;
+		std::size_t count;
+		std::vector<std::string> file_names;
+		unsigned int file_count;
+		unsigned int tid;
+		unsigned int file;
+	};
+
+	// Returns the buffer of a thread to the pool when the thread exits
+	struct ThreadSlot
+	{
+		Buffer* buffer = nullptr;
+		~ThreadSlot();
+	};
+
+	Buffer& ThreadBuffer();
+
+	void Release(Buffer* buffer);
+
+	void Record(const char* name, const char phase);
+
+	static const std::size_t buffer_size_ = 65536;
+	static const std::size_t file_names_size_ = 4096;
+
+	static thread_local ThreadSlot thread_slot_;
+
+	std::atomic<bool> is_active_;
+	boost::filesystem::path file_name_;
+	std::chrono::steady_clock::time_point start_;
+
+	std::vector< std::unique_ptr<Buffer> > buffers_;
+	std::vector<Buffer*> free_buffers_;
+	std::mutex mutex_;
+};
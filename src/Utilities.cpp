@@ -39,6 +39,16 @@
 #include "Conversions.h"
 #include "Composition.h"
 #include "DatabaseSpecies.h"
+#include "PerformanceStatistics.h"
+#include "TraceEvents.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <sstream>
 
 void FatalErrorMessage(const std::string message)
 {
@@ -54,6 +64,8 @@ void ReadConstantValueFromXML(boost::property_tree::ptree& subtree, const std::s
 	{
 		double value = subtree.get<double>("value");
 		units = subtree.get<std::string>("<xmlattr>.units");
+
+		ScopedStageTimer timer("units");
 		CheckAndConvertUnits(name, value, units);
 		values.push_back(value);
 	}
@@ -61,6 +73,8 @@ void ReadConstantValueFromXML(boost::property_tree::ptree& subtree, const std::s
 
 void ReadNonConstantValueFromXML(boost::property_tree::ptree& ptree, const std::string name, std::vector<double>& values, std::string& units)
 {
+	ScopedStageTimer timer("dataGroup");
+
 	std::string id = "n.a.";
 
 	units = "n.a.";
@@ -97,6 +111,8 @@ void ReadProfileFromXML(boost::property_tree::ptree& ptree, const std::string na
 						const std::string name1, std::vector< std::vector<double> >& values1, std::vector<std::string>& units1,
 						const std::string name2, std::vector< std::vector<double> >& values2, std::vector<std::string>& units2)
 {
+	ScopedStageTimer timer("profiles");
+
 	std::vector<std::string> id1;
 	std::vector<std::string> id2;
 	
@@ -176,6 +192,8 @@ void ReadProfileFromXML(boost::property_tree::ptree& ptree, const std::string na
 void ReadNonConstantValueFromXML(boost::property_tree::ptree& ptree, const std::string name, std::vector<Composition>& initial_compositions,
 								const std::vector<std::string>& species_in_kinetic_mech, const bool case_sensitive, DatabaseSpecies& database_species)
 {
+	ScopedStageTimer timer("dataGroup");
+
 	std::vector<std::string> id;
 	std::vector<std::string> composition_names;
 	std::vector<std::string> composition_units;
@@ -232,7 +250,7 @@ void WriteMixStatusOnASCII(const std::string name, std::ofstream& fOut, const do
 	fOut << std::endl;
 }
 
-void WriteOutputOptionsOnASCII(const std::string name, std::ofstream& fOut, const bool verbose_video, const int steps_video, const bool verbose_file, const int steps_file, const boost::filesystem::path& output_folder_simulation)
+void WriteOutputOptionsOnASCII(const std::string name, std::ofstream& fOut, const bool verbose_video, const int steps_video, const bool verbose_file, const int steps_file, const boost::filesystem::path& output_folder_simulation, const std::vector<std::string>& output_species)
 {
 	std::cout << "   - output options" << std::endl;
 
@@ -246,6 +264,13 @@ void WriteOutputOptionsOnASCII(const std::string name, std::ofstream& fOut, cons
 	fOut << "        @VerboseVideo     " << verbose_video_ << ";" << std::endl;
 	fOut << "        @VerboseASCIIFile " << verbose_file_ << ";" << std::endl;
 	fOut << "        @OutputFolder     " << output_folder_simulation.string() << ";" << std::endl;
+	if (output_species.size() != 0)
+	{
+		fOut << "        @OutputSpecies    ";
+		for (unsigned int i = 0; i < output_species.size(); i++)
+			fOut << output_species[i] << " ";
+		fOut << ";" << std::endl;
+	}
 	fOut << "}" << std::endl;
 	fOut << std::endl;
 }
@@ -306,7 +331,7 @@ void WriteParametricAnalysisOnASCII(const std::string name, const std::string ty
 	fOut << std::endl;
 }
 
-void WriteIgnitionDelayTimesOnASCII(const std::string name, std::ofstream& fOut, const bool is_RCM, const idtType idt)
+void WriteIgnitionDelayTimesOnASCII(const std::string name, std::ofstream& fOut, const bool is_RCM, const idtType idt, const FidelityPreset& preset)
 {
 	fOut << "Dictionary " << name << std::endl;
 	fOut << "{" << std::endl;
@@ -366,23 +391,79 @@ void WriteIgnitionDelayTimesOnASCII(const std::string name, std::ofstream& fOut,
 
 		if (is_RCM == true)
 			fOut << "        @RapidCompressionMachine           true;" << std::endl;
-		fOut << "        @FilterWidth                       0.1 ms;" << std::endl;
-		fOut << "        @RegularizationTimeInterval        2.0 ms;" << std::endl;
-		fOut << "        @TemperatureDerivativeThreshold    1.0 K/ms;" << std::endl;
+		fOut << "        @FilterWidth                       " << preset.idt_filter_width_ << ";" << std::endl;
+		fOut << "        @RegularizationTimeInterval        " << preset.idt_regularization_time_interval_ << ";" << std::endl;
+		fOut << "        @TemperatureDerivativeThreshold    " << preset.idt_temperature_derivative_threshold_ << ";" << std::endl;
 		fOut << "        @Verbose                           true;" << std::endl;
 	fOut << "}" << std::endl;
 	fOut << std::endl;
 }
 
-void WriteProfileOnCVS(const boost::filesystem::path file_name,
+int FidelityPreset::Steps(const int steps) const
+{
+	return std::max(1, static_cast<int>(steps * steps_factor_ + 0.5));
+}
+
+FidelityPreset PresetOfFidelity(const ConversionSettings::Fidelity fidelity)
+{
+	FidelityPreset preset;
+
+	// Production: the settings used so far
+	preset.abs_tolerance_ = 1e-14;
+	preset.rel_tolerance_ = 1e-7;
+	preset.steps_factor_ = 1.;
+	preset.grid_initial_points_ = 12;
+	preset.grid_max_points_ = 400;
+	preset.grid_max_adaptive_points_ = 15;
+	preset.grid_gradient_coefficient_ = "0.05";
+	preset.grid_curvature_coefficient_ = "0.5";
+	preset.idt_filter_width_ = "0.1 ms";
+	preset.idt_regularization_time_interval_ = "2.0 ms";
+	preset.idt_temperature_derivative_threshold_ = "1.0 K/ms";
+
+	// Screening: looser tolerances, coarser grids, and sparser output
+	if (fidelity == ConversionSettings::Fidelity::SCREENING)
+	{
+		preset.abs_tolerance_ = 1e-12;
+		preset.rel_tolerance_ = 1e-5;
+		preset.steps_factor_ = 10.;
+		preset.grid_initial_points_ = 8;
+		preset.grid_max_points_ = 150;
+		preset.grid_max_adaptive_points_ = 10;
+		preset.grid_gradient_coefficient_ = "0.1";
+		preset.grid_curvature_coefficient_ = "0.8";
+		preset.idt_filter_width_ = "0.2 ms";
+		preset.idt_temperature_derivative_threshold_ = "2.0 K/ms";
+	}
+
+	// Reference: tighter tolerances, finer grids, and denser output
+	else if (fidelity == ConversionSettings::Fidelity::REFERENCE)
+	{
+		preset.abs_tolerance_ = 1e-16;
+		preset.rel_tolerance_ = 1e-9;
+		preset.steps_factor_ = 0.2;
+		preset.grid_initial_points_ = 20;
+		preset.grid_max_points_ = 1000;
+		preset.grid_max_adaptive_points_ = 25;
+		preset.grid_gradient_coefficient_ = "0.02";
+		preset.grid_curvature_coefficient_ = "0.2";
+		preset.idt_filter_width_ = "0.05 ms";
+		preset.idt_regularization_time_interval_ = "1.0 ms";
+		preset.idt_temperature_derivative_threshold_ = "0.5 K/ms";
+	}
+
+	return preset;
+}
+
+std::string ProfileOnCVS(
 	const std::string variable1, const double value1, const std::string unit1,
 	const std::string variable2, const double value2, const std::string unit2,
-	const std::string name1, const std::vector<double> values1, const std::string units1,
-	const std::string name2, const std::vector<double> values2, const std::string units2)
+	const std::string name1, const std::vector<double>& values1, const std::string units1,
+	const std::string name2, const std::vector<double>& values2, const std::string units2)
 {
-	std::ofstream fOut(file_name.string(), std::ios::out);
+	std::ostringstream fOut;
 	fOut.setf(std::ios::scientific);
-	
+
 	fOut << variable1 << ";" << value1 << " " << unit1 << std::endl;
 	fOut << variable2 << ";" << value2 << " " << unit2 << std::endl;
 	fOut << name1 << ";" << units1 << std::endl;
@@ -391,20 +472,292 @@ void WriteProfileOnCVS(const boost::filesystem::path file_name,
 	for (unsigned int i = 0; i < values1.size(); i++)
 		fOut << values1[i] << ";" << values2[i] << std::endl;
 
+	return fOut.str();
+}
+
+void WriteProfileOnCVS(const boost::filesystem::path file_name,
+	const std::string variable1, const double value1, const std::string unit1,
+	const std::string variable2, const double value2, const std::string unit2,
+	const std::string name1, const std::vector<double> values1, const std::string units1,
+	const std::string name2, const std::vector<double> values2, const std::string units2)
+{
+	const std::string content = ProfileOnCVS(	variable1, value1, unit1, variable2, value2, unit2,
+												name1, values1, units1, name2, values2, units2);
+
+	std::ofstream fOut(file_name.string(), std::ios::out);
+	fOut << content;
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::BYTES_WRITTEN, content.size());
 	fOut.close();
 }
 
+std::string ContentHash(const std::string& content)
+{
+	// 64-bit FNV-1a
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (std::size_t i = 0; i < content.size(); i++)
+	{
+		hash ^= static_cast<unsigned char>(content[i]);
+		hash *= 1099511628211ULL;
+	}
+
+	std::ostringstream hex;
+	hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return hex.str();
+}
+
+bool WriteSharedFile(const boost::filesystem::path& file_name, const std::string& content)
+{
+	// Files already written (or checked) during the current run
+	static std::mutex mutex;
+	static std::set<std::string> written;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (written.count(file_name.string()) != 0)
+		return false;
+
+	// Files written by a previous run in the same output folder
+	if (boost::filesystem::exists(file_name))
+	{
+		std::ifstream fInput(file_name.string(), std::ios::in);
+		const std::string existing((std::istreambuf_iterator<char>(fInput)), std::istreambuf_iterator<char>());
+		if (existing != content)
+			FatalErrorMessage("Hash collision in the profile store: " + file_name.string());
+
+		written.insert(file_name.string());
+		return false;
+	}
+
+	// Written aside and moved in place, so that an interrupted run never leaves a truncated file in the store
+	boost::filesystem::path temporary_file_name = file_name;
+	temporary_file_name += ".tmp";
+
+	std::ofstream fOut(temporary_file_name.string(), std::ios::out);
+	fOut << content;
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::BYTES_WRITTEN, content.size());
+	fOut.close();
+
+	boost::filesystem::rename(temporary_file_name, file_name);
+
+	written.insert(file_name.string());
+	return true;
+}
+
+static bool SameContentOnFile(const boost::filesystem::path& file_name, const std::string& content)
+{
+	if (boost::filesystem::exists(file_name) == false || boost::filesystem::file_size(file_name) != content.size())
+		return false;
+
+	std::ifstream fInput(file_name.string(), std::ios::in | std::ios::binary);
+	const std::string existing((std::istreambuf_iterator<char>(fInput)), std::istreambuf_iterator<char>());
+	return existing == content;
+}
+
+bool WriteFileIfChanged(const boost::filesystem::path& file_name, const std::string& content)
+{
+	// An unchanged file keeps its modification time, so that build tools do not run it again
+	if (SameContentOnFile(file_name, content) == true)
+		return false;
+
+	std::ofstream fOut(file_name.string(), std::ios::out);
+	fOut << content;
+	PerformanceStatistics::Instance().Add(PerformanceStatistics::Counter::BYTES_WRITTEN, content.size());
+	fOut.close();
+
+	return true;
+}
+
+bool ReplaceFileIfChanged(const boost::filesystem::path& temporary_file_name, const boost::filesystem::path& file_name)
+{
+	if (boost::filesystem::exists(file_name) == true)
+	{
+		std::ifstream fInput(temporary_file_name.string(), std::ios::in | std::ios::binary);
+		const std::string content((std::istreambuf_iterator<char>(fInput)), std::istreambuf_iterator<char>());
+		fInput.close();
+
+		if (SameContentOnFile(file_name, content) == true)
+		{
+			boost::filesystem::remove(temporary_file_name);
+			return false;
+		}
+	}
+
+	boost::filesystem::rename(temporary_file_name, file_name);
+	return true;
+}
+
 void ForceMonotonicProfiles(std::vector<double>& x, std::vector<double>& y)
 {
-	std::vector<int> indices;
-	for (unsigned int i = 1; i < x.size(); i++)
-		if (x[i] <= x[i - 1])
-			indices.push_back(i - 1);
+	// Single pass, in place. A backward step (or a duplicated abscissa) replaces the
+	// previous point (the later sample wins), while a point placed before more than
+	// one of the previous points is considered an outlier and is removed
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		if (n > 1 && x[i] <= x[n - 2])
+			continue;
+
+		if (n > 0 && x[i] <= x[n - 1])
+			n--;
+
+		x[n] = x[i];
+		y[n] = y[i];
+		n++;
+	}
+
+	x.resize(n);
+	y.resize(n);
+}
+
+void DecimateProfiles(std::vector<double>& x, std::vector<double>& y, const double tolerance)
+{
+	if (tolerance <= 0. || x.size() < 3)
+		return;
+
+	// Maximum interpolation error (relative to the range of y)
+	const std::pair<std::vector<double>::const_iterator, std::vector<double>::const_iterator> range = std::minmax_element(y.begin(), y.end());
+	const double epsilon = tolerance * (*range.second - *range.first);
+
+	// Ramer-Douglas-Peucker (vertical distance from the chord, explicit stack)
+	std::vector<char> keep(x.size(), 0);
+	keep.front() = 1;
+	keep.back() = 1;
+
+	std::vector< std::pair<std::size_t, std::size_t> > segments;
+	segments.push_back(std::make_pair(std::size_t(0), x.size() - 1));
+	while (segments.empty() == false)
+	{
+		const std::size_t a = segments.back().first;
+		const std::size_t b = segments.back().second;
+		segments.pop_back();
+
+		const double slope = (y[b] - y[a]) / (x[b] - x[a]);
+
+		double max_error = 0.;
+		std::size_t k = a;
+		for (std::size_t i = a + 1; i < b; i++)
+		{
+			const double error = std::fabs(y[i] - (y[a] + slope * (x[i] - x[a])));
+			if (error > max_error)
+			{
+				max_error = error;
+				k = i;
+			}
+		}
+
+		if (max_error > epsilon)
+		{
+			keep[k] = 1;
+			segments.push_back(std::make_pair(a, k));
+			segments.push_back(std::make_pair(k, b));
+		}
+	}
+
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		if (keep[i] == 1)
+		{
+			x[n] = x[i];
+			y[n] = y[i];
+			n++;
+		}
+	}
+
+	x.resize(n);
+	y.resize(n);
+}
+
+void ConditionProfiles(std::vector<double>& x, std::vector<double>& y, const double tolerance)
+{
+	ScopedStageTimer timer("conditioning");
+
+	ForceMonotonicProfiles(x, y);
+	DecimateProfiles(x, y, tolerance);
+}
+
+// Text of the first element with the given tag found after position start; false if the element is not complete
+// or its text needs a real XML parser (entities, CDATA, nested elements)
+static bool TextOfElement(const std::string& head, const std::string& tag, const std::size_t start, std::string& text)
+{
+	const std::size_t open = head.find("<" + tag + ">", start);
+	if (open == std::string::npos)
+		return false;
 
-	std::sort(indices.begin(), indices.end());
-	for (std::vector<int>::reverse_iterator i= indices.rbegin(); i != indices.rend(); ++i)
+	const std::size_t begin = open + tag.size() + 2;
+	const std::size_t end = head.find("</" + tag + ">", begin);
+	if (end == std::string::npos)
+		return false;
+
+	text = head.substr(begin, end - begin);
+	return (text.find_first_of("<&") == std::string::npos);
+}
+
+void ReadExperimentTypeFromXML(const boost::filesystem::path& file_name, std::string& apparatus_kind, std::string& experiment_type)
+{
+	TraceEvents::Instance().SetFileName(file_name.filename().string());
+	ScopedStageTimer timer("classification");
+
+	// experimentType and apparatus precede the (large) data of every ReSpecTh file: only the head of the
+	// file is read, so that each file is parsed once, by the converter
 	{
-		x.erase(x.begin() + *i);
-		y.erase(y.begin() + *i);
+		std::ifstream fInput(file_name.string(), std::ios::in | std::ios::binary);
+
+		std::string head;
+		char buffer[4096];
+		while (head.size() < 65536 && head.find("</apparatus>") == std::string::npos && fInput.read(buffer, sizeof(buffer)).gcount() > 0)
+			head.append(buffer, static_cast<std::size_t>(fInput.gcount()));
+
+		const std::size_t apparatus = head.find("<apparatus>");
+		const std::size_t apparatus_end = (apparatus == std::string::npos) ? std::string::npos : head.find("</apparatus>", apparatus);
+		if (apparatus_end != std::string::npos &&
+			TextOfElement(head.substr(0, apparatus_end), "experimentType", 0, experiment_type) == true &&
+			TextOfElement(head.substr(0, apparatus_end), "kind", apparatus, apparatus_kind) == true)
+			return;
 	}
-}
\ No newline at end of file
+
+	// Unusual layouts are classified by the full parser
+	boost::property_tree::ptree ptree;
+	boost::property_tree::read_xml(file_name.string(), ptree);
+
+	apparatus_kind = ptree.get<std::string>("experiment.apparatus.kind");
+	experiment_type = ptree.get<std::string>("experiment.experimentType");
+}
+
+std::vector<boost::filesystem::path> ListOfXMLFiles(const boost::filesystem::path& folder)
+{
+	TraceEvents::Instance().SetFileName(folder.filename().string());
+	ScopedStageTimer timer("scan");
+
+	std::vector<boost::filesystem::path> list_xml_files;
+
+	boost::filesystem::recursive_directory_iterator it(folder);
+	boost::filesystem::recursive_directory_iterator endit;
+	while (it != endit)
+	{
+		if (boost::filesystem::is_regular_file(*it) && it->path().extension() == ".xml")
+			list_xml_files.push_back(it->path());
+		++it;
+	}
+
+	// The order of the directory walk depends on the file system: sort to make it reproducible
+	std::sort(list_xml_files.begin(), list_xml_files.end());
+
+	return list_xml_files;
+}
+
+std::vector<boost::filesystem::path> ReadListOfFiles(std::istream& fInput)
+{
+	// Names are separated by NUL characters (e.g. find -print0), so that any file name is allowed:
+	// names are taken verbatim, including leading or trailing white spaces and new lines
+	std::vector<boost::filesystem::path> list_files;
+
+	std::string name;
+	while (std::getline(fInput, name, '\0'))
+	{
+		if (name.empty() == false)
+			list_files.push_back(name);
+	}
+
+	return list_files;
+}
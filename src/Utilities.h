@@ -47,6 +47,7 @@
 class Composition;
 class DatabaseSpecies;
 struct idtType;
+struct FidelityPreset;
 
 void FatalErrorMessage(const std::string message);
 
@@ -63,11 +64,11 @@ void ReadProfileFromXML(boost::property_tree::ptree& ptree, const std::string na
 
 void WriteMixStatusOnASCII(const std::string name, std::ofstream& fOut, const double t, const std::string t_units, const double p, const std::string p_units, const Composition& composition);
 
-void WriteOutputOptionsOnASCII(const std::string name, std::ofstream& fOut, const bool verbose_video, const int steps_video, const bool verbose_file, const int steps_file, const boost::filesystem::path& output_folder_simulation);
+void WriteOutputOptionsOnASCII(const std::string name, std::ofstream& fOut, const bool verbose_video, const int steps_video, const bool verbose_file, const int steps_file, const boost::filesystem::path& output_folder_simulation, const std::vector<std::string>& output_species);
 
 void WriteODEParametersOnASCII(const std::string name, std::ofstream& fOut, const double abs_tol, const double rel_tol);
 
-void WriteIgnitionDelayTimesOnASCII(const std::string name, std::ofstream& fOut, const bool is_RCM, const idtType idt);
+void WriteIgnitionDelayTimesOnASCII(const std::string name, std::ofstream& fOut, const bool is_RCM, const idtType idt, const FidelityPreset& preset);
 
 void WriteParametricAnalysisOnASCII(const std::string name, const std::string type, std::ofstream& fOut, const std::vector<double> values, const std::string units);
 
@@ -75,14 +76,38 @@ void WriteParametricAnalysisOnASCII(const std::string name, const std::string ty
 
 void WriteParametricAnalysisOnASCII(const std::string name, const std::string type, std::ofstream& fOut, const std::vector<boost::filesystem::path> file_names);
 
+std::string ProfileOnCVS(
+	const std::string variable1, const double value1, const std::string unit1,
+	const std::string variable2, const double value2, const std::string unit2,
+	const std::string name1, const std::vector<double>& values1, const std::string units1,
+	const std::string name2, const std::vector<double>& values2, const std::string units2);
+
 void WriteProfileOnCVS(const boost::filesystem::path file_name,
 	const std::string variable1, const double value1, const std::string unit1,
 	const std::string variable2, const double value2, const std::string unit2,
 	const std::string name1, const std::vector<double> values1, const std::string units1,
 	const std::string name2, const std::vector<double> values2, const std::string units2);
 
+std::string ContentHash(const std::string& content);
+
+bool WriteSharedFile(const boost::filesystem::path& file_name, const std::string& content);
+
+bool WriteFileIfChanged(const boost::filesystem::path& file_name, const std::string& content);
+
+bool ReplaceFileIfChanged(const boost::filesystem::path& temporary_file_name, const boost::filesystem::path& file_name);
+
 void ForceMonotonicProfiles(std::vector<double>& x, std::vector<double>& y);
 
+void DecimateProfiles(std::vector<double>& x, std::vector<double>& y, const double tolerance);
+
+void ConditionProfiles(std::vector<double>& x, std::vector<double>& y, const double tolerance);
+
+void ReadExperimentTypeFromXML(const boost::filesystem::path& file_name, std::string& apparatus_kind, std::string& experiment_type);
+
+std::vector<boost::filesystem::path> ListOfXMLFiles(const boost::filesystem::path& folder);
+
+std::vector<boost::filesystem::path> ReadListOfFiles(std::istream& fInput);
+
 struct idtType
 {
 	std::string target_;
@@ -90,3 +115,56 @@ struct idtType
 	double amount_;
 	std::string units_;
 };
+
+struct ConversionSettings
+{
+	ConversionSettings() :
+		profile_decimation_tolerance_(0.), share_profiles_(false),
+		end_time_policy_(EndTimePolicy::GLOBAL), end_time_factor_(2.), end_time_bucket_ratio_(10.),
+		residence_time_factor_(0.), merge_residence_times_(false), sample_measured_times_(false),
+		restrict_output_species_(false), reorder_points_(false), max_points_per_dictionary_(0),
+		deduplicate_points_(false), deduplication_tolerance_(1.e-4),
+		seed_flame_speed_(false), flame_speed_bucket_ratio_(2.), plan_flame_grid_(false),
+		fidelity_(Fidelity::PRODUCTION), automatic_tolerances_(false) {}
+
+	double profile_decimation_tolerance_;	// maximum interpolation error of profiles (relative to their range, 0: no decimation)
+	bool share_profiles_;					// profiles written once in a content-addressed store (profiles/<hash>.cvs)
+
+	enum class EndTimePolicy { GLOBAL, BUCKETS, PER_POINT } end_time_policy_;	// end time from all the dataPoints, from buckets of dataPoints, or from each dataPoint
+	double end_time_factor_;				// end time (ignition delay experiments) as a multiple of the measured delay
+	double end_time_bucket_ratio_;			// maximum ratio between the measured delays (residence times) in the same bucket
+	double residence_time_factor_;			// end time (jet stirred reactors) as a multiple of the residence time (0: fixed, 5 s)
+	bool merge_residence_times_;			// outlet concentrations: one integration up to the largest residence time for each (T,P)
+	bool sample_measured_times_;			// concentration time profiles: steps between two outputs derived from the measured times
+	bool restrict_output_species_;			// solvers write only the species in the compositions, measured, or used as ignition target
+	bool reorder_points_;					// cases written along a nearest-neighbour path in the (normalized) space of conditions
+	int max_points_per_dictionary_;			// larger sets of dataPoints are split in chunks written in separate dictionaries (0: no limit)
+	bool deduplicate_points_;				// dataPoints with the same conditions as a dataPoint of another experiment are simulated once
+	double deduplication_tolerance_;		// relative tolerance of the conditions of the same dataPoint (significant digits of the keys)
+	bool seed_flame_speed_;					// flame speeds: initial velocity and domain length from the measured burning velocity
+	double flame_speed_bucket_ratio_;		// maximum ratio between the measured burning velocities in the same bucket
+	bool plan_flame_grid_;					// burner stabilized flames: grid length and number of points from the sampling positions
+
+	enum class Fidelity { SCREENING, PRODUCTION, REFERENCE } fidelity_;		// preset of solver settings (see FidelityPreset)
+	bool automatic_tolerances_;				// absolute tolerance of ODE solvers from the smallest measured mole fraction
+};
+
+// Solver settings written in the dictionaries for a given fidelity (production: the historical values)
+struct FidelityPreset
+{
+	double abs_tolerance_;							// ODE solvers
+	double rel_tolerance_;
+	double steps_factor_;							// multiplies the number of steps between two outputs (not the outputs sampled at measured instants)
+	int grid_initial_points_;						// flames
+	int grid_max_points_;
+	int grid_max_adaptive_points_;
+	std::string grid_gradient_coefficient_;
+	std::string grid_curvature_coefficient_;
+	std::string idt_filter_width_;					// ignition delay detection
+	std::string idt_regularization_time_interval_;
+	std::string idt_temperature_derivative_threshold_;
+
+	int Steps(const int steps) const;
+};
+
+FidelityPreset PresetOfFidelity(const ConversionSettings::Fidelity fidelity);
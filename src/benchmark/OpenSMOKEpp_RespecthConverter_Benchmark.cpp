@@ -0,0 +1,490 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+// Micro-benchmarks of the core routines of the converter. Every case is repeated until
+// the requested minimum time is reached; the time per call is reported together with
+// the time per dataPoint (or per species/value, depending on the case) and the
+// throughput in bytes per second, when meaningful.
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "../Respecth2OpenSMOKEpp.h"
+#include "../Utilities.h"
+#include "../Composition.h"
+#include "../Conversions.h"
+#include "../DatabaseSpecies.h"
+
+namespace
+{
+	double min_time_ = 0.2;
+	std::string filter_ = "";
+	boost::filesystem::path scratch_folder_;
+
+	// Runs the benchmark function until the minimum time is reached
+	void Run(const std::string& name, const std::size_t param, const std::size_t items, std::function<std::size_t()> function)
+	{
+		if (name.find(filter_) == std::string::npos)
+			return;
+
+		// The routines write progress messages on the screen
+		std::streambuf* cout_buffer = std::cout.rdbuf(nullptr);
+
+		// Warm-up
+		std::size_t bytes = function();
+
+		std::size_t iterations = 0;
+		double seconds = 0.;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while (seconds < min_time_)
+		{
+			bytes = function();
+			iterations++;
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		std::cout.rdbuf(cout_buffer);
+
+		const double ns = seconds / static_cast<double>(iterations) * 1.e9;
+
+		std::cout << std::left << std::setw(44) << name << std::right;
+		std::cout << std::setw(8) << param;
+		std::cout << std::setw(12) << iterations;
+		std::cout << std::setw(16) << std::fixed << std::setprecision(1) << ns;
+		std::cout << std::setw(16) << std::fixed << std::setprecision(2) << ns / static_cast<double>(std::max<std::size_t>(items, 1));
+		if (bytes != 0)
+			std::cout << std::setw(12) << std::fixed << std::setprecision(1) << bytes / (ns * 1.e-9) / 1024. / 1024.;
+		else
+			std::cout << std::setw(12) << "-";
+		std::cout << std::endl;
+	}
+
+	std::vector<std::string> MechanismSpecies(const unsigned int ns)
+	{
+		std::vector<std::string> species(ns);
+		species[0] = "N2"; species[1] = "O2"; species[2] = "H2"; species[3] = "CH4"; species[4] = "AR";
+		for (unsigned int i = 5; i < ns; i++)
+			species[i] = "SPC" + std::to_string(i);
+		return species;
+	}
+
+	// ReSpecTh-like ignition delay file with n dataPoints and a V-t history of n points
+	std::string SyntheticXML(const unsigned int n)
+	{
+		std::ostringstream xml;
+		xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
+		xml << "<experiment>" << std::endl;
+		xml << "<fileAuthor>benchmark</fileAuthor>" << std::endl;
+		xml << "<ReSpecThVersion><major>2</major><minor>2</minor></ReSpecThVersion>" << std::endl;
+		xml << "<bibliographyLink><description>benchmark</description></bibliographyLink>" << std::endl;
+		xml << "<experimentType>ignition delay measurement</experimentType>" << std::endl;
+		xml << "<apparatus><kind>shock tube</kind></apparatus>" << std::endl;
+		xml << "<commonProperties>" << std::endl;
+		xml << "<property name=\"pressure\" label=\"p\" units=\"Torr\"><value>760</value></property>" << std::endl;
+		xml << "<property name=\"initial composition\" label=\"composition\">" << std::endl;
+		xml << "<component><speciesLink preferredKey=\"H2\" CAS=\"1333-74-0\"/><amount units=\"mole fraction\">0.02</amount></component>" << std::endl;
+		xml << "<component><speciesLink preferredKey=\"O2\" CAS=\"7782-44-7\"/><amount units=\"mole fraction\">0.01</amount></component>" << std::endl;
+		xml << "<component><speciesLink preferredKey=\"Ar\" CAS=\"7440-37-1\"/><amount units=\"mole fraction\">0.97</amount></component>" << std::endl;
+		xml << "</property>" << std::endl;
+		xml << "</commonProperties>" << std::endl;
+		xml << "<dataGroup id=\"dg1\">" << std::endl;
+		xml << "<property name=\"temperature\" id=\"x1\" label=\"T\" units=\"K\"/>" << std::endl;
+		xml << "<property name=\"ignition delay\" id=\"x2\" label=\"tau\" units=\"us\"/>" << std::endl;
+		for (unsigned int i = 0; i < n; i++)
+			xml << "<dataPoint><x1>" << 1000. + i << "</x1><x2>" << 100. + 0.5 * i << "</x2></dataPoint>" << std::endl;
+		xml << "</dataGroup>" << std::endl;
+		xml << "<dataGroup id=\"dg2\" label=\"V-t history\">" << std::endl;
+		xml << "<property name=\"time\" id=\"x3\" units=\"ms\"/>" << std::endl;
+		xml << "<property name=\"volume\" id=\"x4\" units=\"cm3\"/>" << std::endl;
+		for (unsigned int i = 0; i < n; i++)
+			xml << "<dataPoint><x3>" << 0.01 * i << "</x3><x4>" << 1. + 0.001 * i << "</x4></dataPoint>" << std::endl;
+		xml << "</dataGroup>" << std::endl;
+		xml << "<ignitionType target=\"OH*\" type=\"d/dt max\"/>" << std::endl;
+		xml << "</experiment>" << std::endl;
+		return xml.str();
+	}
+
+	boost::property_tree::ptree ParseXML(const std::string& text)
+	{
+		boost::property_tree::ptree ptree;
+		std::istringstream stream(text);
+		boost::property_tree::read_xml(stream, ptree);
+		return ptree;
+	}
+
+	// Converter used only to access the members of the base class
+	class BenchmarkConverter : public Respecth2OpenSMOKEpp
+	{
+	public:
+
+		BenchmarkConverter(const boost::filesystem::path file_name, const std::vector<std::string> species, DatabaseSpecies& database_species) :
+			Respecth2OpenSMOKEpp(file_name, "kinetics", "output", species, false, database_species, ConversionSettings()) {}
+
+		// Constant values are appended by ReadConstantValueFromXML
+		void Reset()
+		{
+			t_values_.clear(); p_values_.clear(); tau_values_.clear(); v_values_.clear();
+			phi_values_.clear(); m_values_.clear(); sl_values_.clear(); dpdt_values_.clear();
+			initial_compositions_.clear();
+		}
+
+	private:
+
+		virtual std::string Solver() const { return ""; };
+		virtual void WriteSimulationData(std::ofstream& fOut) {};
+		virtual void WriteAdditionalFiles() {};
+	};
+
+	void BenchmarkReaders(const std::vector<unsigned int>& sizes)
+	{
+		std::vector<std::string> species = MechanismSpecies(50);
+		DatabaseSpecies database_species;
+
+		for (unsigned int k = 0; k < sizes.size(); k++)
+		{
+			const unsigned int n = sizes[k];
+			const std::string text = SyntheticXML(n);
+			boost::property_tree::ptree ptree = ParseXML(text);
+
+			Run("ParseXML", n, n, [&]() { ParseXML(text); return text.size(); });
+
+			Run("ReadNonConstantValueFromXML", n, n, [&]()
+			{
+				std::vector<double> values; std::string units;
+				ReadNonConstantValueFromXML(ptree, "temperature", values, units);
+				return std::size_t(0);
+			});
+
+			Run("ReadProfileFromXML", n, n, [&]()
+			{
+				std::vector< std::vector<double> > v, t; std::vector<std::string> v_units, t_units;
+				ReadProfileFromXML(ptree, "V-t history", "volume", v, v_units, "time", t, t_units);
+				return std::size_t(0);
+			});
+		}
+
+		// Constant values do not depend on the number of dataPoints
+		{
+			const boost::filesystem::path file_name = scratch_folder_ / "benchmark.xml";
+			std::ofstream fOut(file_name.string(), std::ios::out);
+			fOut << SyntheticXML(10);
+			fOut.close();
+
+			boost::property_tree::ptree ptree = ParseXML(SyntheticXML(10));
+			Run("ReadConstantValueFromXML (free)", 1, 1, [&]()
+			{
+				std::vector<double> values; std::string units;
+				BOOST_FOREACH(boost::property_tree::ptree::value_type& node, ptree.get_child("experiment.commonProperties"))
+					if (node.first == "property")
+						ReadConstantValueFromXML(node.second, "pressure", values, units);
+				return std::size_t(0);
+			});
+
+			BenchmarkConverter converter(file_name, species, database_species);
+			Run("ReadConstantValueFromXML (member)", 1, 1, [&]()
+			{
+				converter.Reset();
+				converter.ReadConstantValueFromXML();
+				return std::size_t(0);
+			});
+		}
+	}
+
+	void BenchmarkComposition(const std::vector<unsigned int>& sizes)
+	{
+		for (unsigned int k = 0; k < sizes.size(); k++)
+		{
+			const unsigned int ns = sizes[k];
+			const std::vector<std::string> species = MechanismSpecies(ns);
+
+			// Species are looked up at the end of the list (worst case)
+			const std::vector<std::string> names = { "SPC" + std::to_string(ns - 1), "spc" + std::to_string(ns - 2), "n2" };
+			const std::vector<double> values = { 0.1, 0.1, 0.8 };
+			const std::vector<std::string> units(3, "mole fraction");
+			const std::vector<std::string> empty(3, "");
+
+			DatabaseSpecies database_species;
+
+			Run("Composition::Set (case sensitive)", ns, names.size(), [&]()
+			{
+				const std::vector<std::string> exact = { "SPC" + std::to_string(ns - 1), "SPC" + std::to_string(ns - 2), "N2" };
+				Composition composition;
+				composition.Set(exact, values, units, empty, empty, species, true, database_species);
+				return std::size_t(0);
+			});
+
+			Run("Composition::Set (case insensitive)", ns, names.size(), [&]()
+			{
+				Composition composition;
+				composition.Set(names, values, units, empty, empty, species, false, database_species);
+				return std::size_t(0);
+			});
+
+			// Database of species names with the same size of the mechanism
+			const boost::filesystem::path file_name = scratch_folder_ / "database.xml";
+			{
+				std::ofstream fOut(file_name.string(), std::ios::out);
+				fOut << "<database>" << std::endl;
+				for (unsigned int i = 0; i < ns; i++)
+					fOut << "<species name=\"" << species[i] << "\" chemName=\"chem" << i << "\" CAS=\"" << i << "-00-0\"/>" << std::endl;
+				fOut << "</database>" << std::endl;
+			}
+
+			std::streambuf* cout_buffer = std::cout.rdbuf(nullptr);
+			database_species.SetFromXML(file_name);
+			std::cout.rdbuf(cout_buffer);
+
+			const std::vector<std::string> cas = { std::to_string(ns - 1) + "-00-0", "", std::to_string(ns - 3) + "-00-0" };
+			const std::vector<std::string> chem = { "", "chem" + std::to_string(ns - 2), "" };
+			Run("DatabaseSpecies lookup (CAS, chemName)", ns, names.size(), [&]()
+			{
+				Composition composition;
+				composition.Set(names, values, units, chem, cas, species, false, database_species);
+				return std::size_t(0);
+			});
+		}
+	}
+
+	void BenchmarkProfiles(const std::vector<unsigned int>& sizes)
+	{
+		for (unsigned int k = 0; k < sizes.size(); k++)
+		{
+			const unsigned int n = sizes[k];
+
+			std::vector<double> values(n, 760.);
+			Run("CheckAndConvertUnits", n, n, [&]()
+			{
+				std::string units = "Torr";
+				CheckAndConvertUnits("pressure", values, units);
+				return std::size_t(0);
+			});
+
+			// Noisy time series: one point out of ten steps backward
+			std::vector<double> x(n), y(n);
+			for (unsigned int i = 0; i < n; i++)
+			{
+				x[i] = (i % 10 == 9) ? (i - 1.5) : static_cast<double>(i);
+				y[i] = 1. + 0.001 * i;
+			}
+
+			Run("ForceMonotonicProfiles", n, n, [&]()
+			{
+				std::vector<double> xx = x;
+				std::vector<double> yy = y;
+				ForceMonotonicProfiles(xx, yy);
+				return std::size_t(0);
+			});
+
+			// Smooth volume history (compression and expansion)
+			for (unsigned int i = 0; i < n; i++)
+			{
+				x[i] = static_cast<double>(i);
+				y[i] = 1. + std::sin(3. * i / n) + 0.1 * std::cos(40. * i / n);
+			}
+
+			Run("DecimateProfiles (1e-3)", n, n, [&]()
+			{
+				std::vector<double> xx = x;
+				std::vector<double> yy = y;
+				DecimateProfiles(xx, yy, 1.e-3);
+				return std::size_t(0);
+			});
+		}
+	}
+
+	void BenchmarkEmitters(const std::vector<unsigned int>& sizes)
+	{
+		const boost::filesystem::path file_name = scratch_folder_ / "benchmark.dic";
+		std::ofstream fOut(file_name.string(), std::ios::out);
+		fOut.setf(std::ios::scientific);
+
+		DatabaseSpecies database_species;
+		const std::vector<std::string> species = MechanismSpecies(50);
+
+		Composition composition;
+		composition.Set({ "H2", "O2", "AR" }, { 0.02, 0.01, 0.97 }, std::vector<std::string>(3, "mole fraction"),
+			std::vector<std::string>(3, ""), std::vector<std::string>(3, ""), species, false, database_species);
+
+		idtType idt;
+		idt.target_ = "OH"; idt.type_ = "d/dt max"; idt.amount_ = 0.; idt.units_ = "unitless";
+		const FidelityPreset preset = PresetOfFidelity(ConversionSettings::Fidelity::PRODUCTION);
+
+		for (unsigned int k = 0; k < sizes.size(); k++)
+		{
+			const unsigned int n = sizes[k];
+
+			std::vector<double> values(n), values2(n);
+			std::vector<boost::filesystem::path> file_names(n);
+			for (unsigned int i = 0; i < n; i++)
+			{
+				values[i] = 1000. + i;
+				values2[i] = 1.e5 + i;
+				file_names[i] = "benchmark." + std::to_string(i + 1) + ".cvs";
+			}
+
+			Run("WriteParametricAnalysisOnASCII (1 list)", n, n, [&]()
+			{
+				fOut.seekp(0);
+				WriteParametricAnalysisOnASCII("parametric-analysis", "temperature", fOut, values, "K");
+				return static_cast<std::size_t>(fOut.tellp());
+			});
+
+			Run("WriteParametricAnalysisOnASCII (2 lists)", n, n, [&]()
+			{
+				fOut.seekp(0);
+				WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, values, "K", values2, "Pa");
+				return static_cast<std::size_t>(fOut.tellp());
+			});
+
+			Run("WriteParametricAnalysisOnASCII (profiles)", n, n, [&]()
+			{
+				fOut.seekp(0);
+				WriteParametricAnalysisOnASCII("parametric-analysis", "temperature-pressure", fOut, file_names);
+				return static_cast<std::size_t>(fOut.tellp());
+			});
+
+			Run("WriteProfileOnCVS", n, n, [&]()
+			{
+				WriteProfileOnCVS(scratch_folder_ / "benchmark.cvs", "temperature", 1000., "K", "pressure", 1.e5, "Pa",
+					"time", values, "ms", "volume", values2, "cm3");
+				return static_cast<std::size_t>(boost::filesystem::file_size(scratch_folder_ / "benchmark.cvs"));
+			});
+		}
+
+		Run("WriteMixStatusOnASCII", 1, 1, [&]()
+		{
+			fOut.seekp(0);
+			WriteMixStatusOnASCII("mix-status", fOut, 1000., "K", 1., "atm", composition);
+			return static_cast<std::size_t>(fOut.tellp());
+		});
+
+		Run("WriteOutputOptionsOnASCII", 1, 1, [&]()
+		{
+			fOut.seekp(0);
+			WriteOutputOptionsOnASCII("output-options", fOut, true, 1000, true, 5, "output", std::vector<std::string>());
+			return static_cast<std::size_t>(fOut.tellp());
+		});
+
+		Run("WriteODEParametersOnASCII", 1, 1, [&]()
+		{
+			fOut.seekp(0);
+			WriteODEParametersOnASCII("ode-parameters", fOut, 1e-14, 1e-7);
+			return static_cast<std::size_t>(fOut.tellp());
+		});
+
+		Run("WriteIgnitionDelayTimesOnASCII", 1, 1, [&]()
+		{
+			fOut.seekp(0);
+			WriteIgnitionDelayTimesOnASCII("ignition-delay-times", fOut, false, idt, preset);
+			return static_cast<std::size_t>(fOut.tellp());
+		});
+
+		fOut.close();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	namespace po = boost::program_options;
+	po::options_description description("Options for the OpenSMOKEpp_RespecthConverter_Benchmark");
+	description.add_options()
+		("help", "print help messages")
+		("filter", po::value<std::string>(), "run only the benchmarks whose name contains the given string")
+		("min-time", po::value<double>(), "minimum time for each benchmark in s (default 0.2)")
+		("quick", "reduced set of sizes");
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, description), vm);
+		po::notify(vm);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl << std::endl;
+		std::cerr << description << std::endl;
+		return -1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+
+	if (vm.count("filter"))
+		filter_ = vm["filter"].as<std::string>();
+
+	if (vm.count("min-time"))
+		min_time_ = vm["min-time"].as<double>();
+
+	std::vector<unsigned int> data_points = { 10, 100, 1000, 10000 };
+	std::vector<unsigned int> mechanism_species = { 50, 500, 5000 };
+	if (vm.count("quick"))
+	{
+		data_points = { 10, 1000 };
+		mechanism_species = { 50, 5000 };
+	}
+
+	scratch_folder_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("respecth-benchmark-%%%%%%%%");
+	boost::filesystem::create_directories(scratch_folder_);
+
+	std::cout << std::left << std::setw(44) << "Benchmark" << std::right;
+	std::cout << std::setw(8) << "Size" << std::setw(12) << "Iterations" << std::setw(16) << "ns/call";
+	std::cout << std::setw(16) << "ns/item" << std::setw(12) << "MB/s" << std::endl;
+	std::cout << std::string(108, '-') << std::endl;
+
+	BenchmarkReaders(data_points);
+	BenchmarkComposition(mechanism_species);
+	BenchmarkProfiles(data_points);
+	BenchmarkEmitters(data_points);
+
+	boost::filesystem::remove_all(scratch_folder_);
+
+	return 0;
+}
@@ -0,0 +1,518 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+// Generator of synthetic ReSpecTh corpora for load testing. The files cover the six
+// experiment types recognized by the converter (ignition delay with and without
+// V-t histories, jet stirred reactor, laminar burning velocity, burner-stabilized
+// flame speciation, concentration time profile and outlet concentration). Species
+// are drawn from the kinetics.xml file of a preprocessed kinetic mechanism, so that
+// the generated compositions go through the usual species-resolution path.
+// A fraction of files can be deliberately corrupted: the list of generated files,
+// together with the injected errors, is written in the corpus.txt manifest.
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/algorithm/string.hpp>
+
+namespace
+{
+	enum class Kind { IDT, IDT_VT, JSR, LBV, BSF, CTP, OC };
+
+	enum class Error { NONE, UNKNOWN_SPECIES, UNKNOWN_UNITS, WRONG_SUM, MISSING_ELEMENT, TRUNCATED };
+
+	const std::vector<std::string> kind_names_ = { "idt", "idt-vt", "jsr", "lbv", "bsf", "ctp", "oc" };
+
+	const std::vector<std::string> error_names_ = { "none", "unknown-species", "unknown-units", "wrong-sum", "missing-element", "truncated" };
+
+	struct Settings
+	{
+		unsigned int points;
+		unsigned int species;
+		unsigned int profile_length;
+		double errors;
+	};
+
+	class Generator
+	{
+	public:
+
+		Generator(const std::vector<std::string>& species, const Settings& settings, const unsigned int seed) :
+			species_(species), settings_(settings), random_(seed) {}
+
+		std::string Generate(const Kind kind, const Error error, const unsigned int index);
+
+	private:
+
+		double Uniform(const double a, const double b) { return std::uniform_real_distribution<double>(a, b)(random_); }
+
+		// Distinct species from the kinetic mechanism (the last one is the bath gas)
+		std::vector<std::string> DrawSpecies(const unsigned int n);
+
+		// Mole fractions summing to 1 (the last one is the bath gas)
+		std::vector<double> DrawComposition(const unsigned int n);
+
+		void Header(std::ostream& xml, const std::string& experiment_type, const std::string& apparatus_kind, const Error error, const unsigned int index);
+		void Property(std::ostream& xml, const std::string& name, const std::string& units, const double value);
+		void InitialComposition(std::ostream& xml, const std::vector<std::string>& names, const std::vector<double>& values);
+		void Column(std::ostream& xml, const std::string& name, const std::string& id, const std::string& units);
+		void SpeciesColumn(std::ostream& xml, const std::string& name, const std::string& id);
+
+		const std::vector<std::string>& species_;
+		Settings settings_;
+		std::mt19937 random_;
+
+		// Current error (only one per file)
+		Error error_;
+	};
+
+	std::vector<std::string> Generator::DrawSpecies(const unsigned int n)
+	{
+		std::vector<std::string> names(species_);
+		std::shuffle(names.begin(), names.end(), random_);
+		names.resize(std::min<std::size_t>(n, names.size()));
+
+		if (error_ == Error::UNKNOWN_SPECIES)
+			names[0] = "UNKNOWN-SPECIES";
+
+		return names;
+	}
+
+	std::vector<double> Generator::DrawComposition(const unsigned int n)
+	{
+		std::vector<double> values(n);
+		double sum = 0.;
+		for (unsigned int i = 0; i < n - 1; i++)
+		{
+			// Lower bound always below the upper one, also for large mechanisms (the remaining species gets at least 0.5)
+			values[i] = std::round(Uniform(std::min(0.001, 0.25 / n), 0.5 / n) * 1.e6) / 1.e6;
+			sum += values[i];
+		}
+		values[n - 1] = 1. - sum;
+
+		if (error_ == Error::WRONG_SUM)
+			values[n - 1] += 0.5;
+
+		return values;
+	}
+
+	void Generator::Header(std::ostream& xml, const std::string& experiment_type, const std::string& apparatus_kind, const Error error, const unsigned int index)
+	{
+		xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << std::endl;
+		xml << "<experiment>" << std::endl;
+		if (error != Error::MISSING_ELEMENT)
+			xml << "  <fileAuthor>Synthetic corpus generator</fileAuthor>" << std::endl;
+		xml << "  <fileDOI>10.0000/synthetic." << index << "</fileDOI>" << std::endl;
+		xml << "  <fileVersion><major>1</major><minor>0</minor></fileVersion>" << std::endl;
+		xml << "  <ReSpecThVersion><major>2</major><minor>2</minor></ReSpecThVersion>" << std::endl;
+		xml << "  <bibliographyLink>" << std::endl;
+		xml << "    <description>Synthetic experiment " << index << "</description>" << std::endl;
+		xml << "    <referenceDOI>10.0000/synthetic</referenceDOI>" << std::endl;
+		xml << "  </bibliographyLink>" << std::endl;
+		xml << "  <experimentType>" << experiment_type << "</experimentType>" << std::endl;
+		xml << "  <apparatus>" << std::endl;
+		xml << "    <kind>" << apparatus_kind << "</kind>" << std::endl;
+		xml << "  </apparatus>" << std::endl;
+	}
+
+	void Generator::Property(std::ostream& xml, const std::string& name, const std::string& units, const double value)
+	{
+		xml << "    <property name=\"" << name << "\" label=\"" << name << "\" sourcetype=\"reported\" units=\"" << units << "\">" << std::endl;
+		xml << "      <value>" << value << "</value>" << std::endl;
+		xml << "    </property>" << std::endl;
+	}
+
+	void Generator::InitialComposition(std::ostream& xml, const std::vector<std::string>& names, const std::vector<double>& values)
+	{
+		xml << "    <property name=\"initial composition\" sourcetype=\"reported\">" << std::endl;
+		for (unsigned int i = 0; i < names.size(); i++)
+		{
+			xml << "      <component>" << std::endl;
+			xml << "        <speciesLink preferredKey=\"" << names[i] << "\"/>" << std::endl;
+			xml << "        <amount units=\"mole fraction\">" << values[i] << "</amount>" << std::endl;
+			xml << "      </component>" << std::endl;
+		}
+		xml << "    </property>" << std::endl;
+	}
+
+	void Generator::Column(std::ostream& xml, const std::string& name, const std::string& id, const std::string& units)
+	{
+		xml << "    <property name=\"" << name << "\" id=\"" << id << "\" label=\"" << name << "\" sourcetype=\"reported\" units=\"" << units << "\"/>" << std::endl;
+	}
+
+	void Generator::SpeciesColumn(std::ostream& xml, const std::string& name, const std::string& id)
+	{
+		xml << "    <property name=\"composition\" id=\"" << id << "\" label=\"[" << name << "]\" sourcetype=\"reported\" units=\"mole fraction\">" << std::endl;
+		xml << "      <speciesLink preferredKey=\"" << name << "\"/>" << std::endl;
+		xml << "    </property>" << std::endl;
+	}
+
+	std::string Generator::Generate(const Kind kind, const Error error, const unsigned int index)
+	{
+		error_ = error;
+
+		const unsigned int np = settings_.points;
+		const unsigned int nl = settings_.profile_length;
+		const unsigned int ns = settings_.species;
+
+		const std::string temperature_units = (error == Error::UNKNOWN_UNITS) ? "C" : "K";
+		const double pressure = std::round(Uniform(1., 50.) * 10.) / 10.;
+		const double temperature = std::round(Uniform(300., 800.));
+
+		const std::vector<std::string> names = DrawSpecies(ns);
+		const std::vector<double> composition = DrawComposition(static_cast<unsigned int>(names.size()));
+
+		std::ostringstream xml;
+		xml << std::setprecision(10);
+
+		if (kind == Kind::IDT || kind == Kind::IDT_VT)
+		{
+			Header(xml, "ignition delay measurement", (kind == Kind::IDT) ? "shock tube" : "rapid compression machine", error, index);
+
+			xml << "  <commonProperties>" << std::endl;
+			Property(xml, "pressure", "atm", pressure);
+			InitialComposition(xml, names, composition);
+			xml << "  </commonProperties>" << std::endl;
+
+			xml << "  <dataGroup id=\"dg1\">" << std::endl;
+			Column(xml, "temperature", "x1", temperature_units);
+			Column(xml, "ignition delay", "x2", "us");
+			for (unsigned int i = 0; i < np; i++)
+			{
+				const double t = 700. + 800. * (i + Uniform(0., 1.)) / np;
+				xml << "    <dataPoint><x1>" << std::round(t) << "</x1><x2>" << 10. * std::exp(12000. / t - 8.) << "</x2></dataPoint>" << std::endl;
+			}
+			xml << "  </dataGroup>" << std::endl;
+
+			// Compression followed by heat losses, with noisy time stamps
+			if (kind == Kind::IDT_VT)
+			{
+				for (unsigned int i = 0; i < np; i++)
+				{
+					const double compression_ratio = Uniform(8., 12.);
+					xml << "  <dataGroup id=\"dg" << i + 2 << "\" label=\"V-t history\">" << std::endl;
+					Column(xml, "time", "x" + std::to_string(2 * i + 3), "s");
+					Column(xml, "volume", "x" + std::to_string(2 * i + 4), "cm3");
+					for (unsigned int j = 0; j < nl; j++)
+					{
+						const double s = static_cast<double>(j) / std::max(nl - 1, 1u);
+						const double time = 0.05 * s + ((j % 7 == 6) ? -0.06 / std::max(nl, 1u) : 0.);
+						const double volume = (s < 0.4) ? 500. * (1. - (1. - 1. / compression_ratio) * std::sin(0.5 * M_PI * s / 0.4)) :
+							500. / compression_ratio * (1. + 0.2 * (s - 0.4));
+						xml << "    <dataPoint><x" << 2 * i + 3 << ">" << time << "</x" << 2 * i + 3 << "><x" << 2 * i + 4 << ">" << volume << "</x" << 2 * i + 4 << "></dataPoint>" << std::endl;
+					}
+					xml << "  </dataGroup>" << std::endl;
+				}
+			}
+
+			xml << "  <ignitionType target=\"" << ((kind == Kind::IDT) ? "OH*" : "p") << "\" type=\"d/dt max\"/>" << std::endl;
+		}
+		else if (kind == Kind::JSR || kind == Kind::OC)
+		{
+			// Measured species are drawn among the species of the mechanism
+			const std::vector<std::string> measured(species_.begin(), species_.begin() + std::min<std::size_t>(ns, species_.size()));
+
+			Header(xml, (kind == Kind::JSR) ? "jet stirred reactor measurement" : "outlet concentration measurement",
+				(kind == Kind::JSR) ? "stirred reactor" : "flow reactor", error, index);
+
+			xml << "  <commonProperties>" << std::endl;
+			Property(xml, "pressure", "atm", pressure);
+			InitialComposition(xml, names, composition);
+			if (kind == Kind::JSR)
+			{
+				Property(xml, "residence time", "s", std::round(Uniform(0.5, 4.) * 10.) / 10.);
+				Property(xml, "volume", "cm3", 85.);
+			}
+			xml << "  </commonProperties>" << std::endl;
+
+			xml << "  <dataGroup id=\"dg1\">" << std::endl;
+			Column(xml, "temperature", "x1", temperature_units);
+			if (kind == Kind::OC)
+				Column(xml, "residence time", "x2", "s");
+			for (unsigned int k = 0; k < measured.size(); k++)
+				SpeciesColumn(xml, measured[k], "x" + std::to_string(k + 3));
+			for (unsigned int i = 0; i < np; i++)
+			{
+				xml << "    <dataPoint><x1>" << std::round(600. + 600. * i / std::max(np, 1u)) << "</x1>";
+				if (kind == Kind::OC)
+					xml << "<x2>" << std::round(Uniform(0.05, 2.) * 100.) / 100. << "</x2>";
+				for (unsigned int k = 0; k < measured.size(); k++)
+					xml << "<x" << k + 3 << ">" << Uniform(1.e-6, 1.e-3) << "</x" << k + 3 << ">";
+				xml << "</dataPoint>" << std::endl;
+			}
+			xml << "  </dataGroup>" << std::endl;
+		}
+		else if (kind == Kind::LBV)
+		{
+			// Even files: variable temperature; odd files: variable composition
+			const bool variable_composition = (index % 2 == 1);
+
+			Header(xml, "laminar burning velocity measurement", "flame", error, index);
+
+			xml << "  <commonProperties>" << std::endl;
+			Property(xml, "pressure", "atm", pressure);
+			if (variable_composition == true)
+				Property(xml, "temperature", temperature_units, temperature);
+			else
+				InitialComposition(xml, names, composition);
+			xml << "  </commonProperties>" << std::endl;
+
+			xml << "  <dataGroup id=\"dg1\">" << std::endl;
+			if (variable_composition == false)
+				Column(xml, "temperature", "x1", temperature_units);
+			Column(xml, "laminar burning velocity", "x2", "cm/s");
+			if (variable_composition == true)
+				for (unsigned int k = 0; k < names.size(); k++)
+					SpeciesColumn(xml, names[k], "x" + std::to_string(k + 3));
+			for (unsigned int i = 0; i < np; i++)
+			{
+				xml << "    <dataPoint>";
+				if (variable_composition == false)
+					xml << "<x1>" << std::round(300. + 200. * i / std::max(np, 1u)) << "</x1>";
+				xml << "<x2>" << std::round(Uniform(10., 80.) * 100.) / 100. << "</x2>";
+				if (variable_composition == true)
+				{
+					const std::vector<double> x = DrawComposition(static_cast<unsigned int>(names.size()));
+					for (unsigned int k = 0; k < names.size(); k++)
+						xml << "<x" << k + 3 << ">" << x[k] << "</x" << k + 3 << ">";
+				}
+				xml << "</dataPoint>" << std::endl;
+			}
+			xml << "  </dataGroup>" << std::endl;
+		}
+		else if (kind == Kind::BSF)
+		{
+			Header(xml, "burner stabilized flame speciation measurement", "flame", error, index);
+
+			xml << "  <commonProperties>" << std::endl;
+			Property(xml, "temperature", temperature_units, temperature);
+			Property(xml, "pressure", "atm", std::round(Uniform(0.02, 1.) * 100.) / 100.);
+			InitialComposition(xml, names, composition);
+			Property(xml, "flow rate", "g cm-2 s-1", std::round(Uniform(0.002, 0.01) * 1.e5) / 1.e5);
+			xml << "  </commonProperties>" << std::endl;
+
+			// Temperature profile along the distance from the burner (the first point is not at the burner)
+			xml << "  <dataGroup id=\"dg1\">" << std::endl;
+			Column(xml, "distance", "x1", "cm");
+			Column(xml, "temperature", "x2", "K");
+			for (unsigned int k = 0; k < names.size(); k++)
+				SpeciesColumn(xml, names[k], "x" + std::to_string(k + 3));
+			for (unsigned int i = 0; i < nl; i++)
+			{
+				const double x = 0.01 + 2. * i / std::max(nl, 1u);
+				xml << "    <dataPoint><x1>" << x << "</x1><x2>" << temperature + 1500. * std::tanh(3. * x) << "</x2>";
+				for (unsigned int k = 0; k < names.size(); k++)
+					xml << "<x" << k + 3 << ">" << composition[k] * std::exp(-x) << "</x" << k + 3 << ">";
+				xml << "</dataPoint>" << std::endl;
+			}
+			xml << "  </dataGroup>" << std::endl;
+		}
+		else if (kind == Kind::CTP)
+		{
+			Header(xml, "concentration time profile measurement", "shock tube", error, index);
+
+			xml << "  <commonProperties>" << std::endl;
+			Property(xml, "temperature", temperature_units, std::round(Uniform(1000., 2000.)));
+			Property(xml, "pressure", "atm", pressure);
+			InitialComposition(xml, names, composition);
+			xml << "  </commonProperties>" << std::endl;
+
+			xml << "  <dataGroup id=\"dg1\">" << std::endl;
+			Column(xml, "time", "x1", "us");
+			SpeciesColumn(xml, names[0], "x2");
+			for (unsigned int i = 0; i < nl; i++)
+			{
+				const double time = 1000. * i / std::max(nl, 1u);
+				xml << "    <dataPoint><x1>" << time << "</x1><x2>" << composition[0] * std::exp(-time / 300.) << "</x2></dataPoint>" << std::endl;
+			}
+			xml << "  </dataGroup>" << std::endl;
+		}
+
+		xml << "</experiment>" << std::endl;
+
+		std::string text = xml.str();
+		if (error == Error::TRUNCATED)
+			text.resize(text.size() / 2);
+
+		return text;
+	}
+
+	std::vector<std::string> ReadSpeciesFromKinetics(const boost::filesystem::path& path)
+	{
+		const boost::filesystem::path file_name = boost::filesystem::is_directory(path) ? path / "kinetics.xml" : path;
+
+		boost::property_tree::ptree ptree;
+		boost::property_tree::read_xml(file_name.string(), ptree);
+
+		const unsigned int ns = ptree.get<unsigned int>("opensmoke.NumberOfSpecies");
+		std::vector<std::string> species(ns);
+
+		std::stringstream stream;
+		stream.str(ptree.get< std::string >("opensmoke.NamesOfSpecies"));
+		for (unsigned int i = 0; i < ns; i++)
+			stream >> species[i];
+
+		return species;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	namespace po = boost::program_options;
+	po::options_description description("Options for the OpenSMOKEpp_RespecthConverter_CorpusGenerator");
+	description.add_options()
+		("help", "print help messages")
+		("kinetics", po::value<std::string>(), "kinetics folder (or kinetics.xml file) from which species are drawn")
+		("output", po::value<std::string>(), "output folder (created if needed)")
+		("files", po::value<unsigned int>()->default_value(70), "number of files")
+		("points", po::value<unsigned int>()->default_value(10), "number of dataPoints per file")
+		("species", po::value<unsigned int>()->default_value(4), "number of species per composition")
+		("profile-length", po::value<unsigned int>()->default_value(100), "number of points of V-t histories and of flame/time profiles")
+		("errors", po::value<double>()->default_value(0.), "fraction of files with an injected error")
+		("types", po::value<std::string>()->default_value("idt,idt-vt,jsr,lbv,bsf,ctp,oc"), "comma-separated list of experiment types")
+		("seed", po::value<unsigned int>()->default_value(1), "seed of the random generator");
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, description), vm);
+		po::notify(vm);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl << std::endl;
+		std::cerr << description << std::endl;
+		return -1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+
+	if (vm.count("kinetics") == 0 || vm.count("output") == 0)
+	{
+		std::cerr << "Fatal error: --kinetics and --output must be provided" << std::endl << std::endl;
+		std::cerr << description << std::endl;
+		return -1;
+	}
+
+	Settings settings;
+	settings.points = vm["points"].as<unsigned int>();
+	settings.species = vm["species"].as<unsigned int>();
+	settings.profile_length = vm["profile-length"].as<unsigned int>();
+	settings.errors = vm["errors"].as<double>();
+
+	if (settings.points == 0 || settings.profile_length == 0 || settings.species < 2)
+	{
+		std::cerr << "Fatal error: at least 1 dataPoint, 1 profile point and 2 species are required" << std::endl;
+		return -1;
+	}
+
+	// Experiment types
+	std::vector<Kind> kinds;
+	{
+		std::vector<std::string> names;
+		boost::split(names, vm["types"].as<std::string>(), boost::is_any_of(","));
+		for (unsigned int i = 0; i < names.size(); i++)
+		{
+			const std::vector<std::string>::const_iterator it = std::find(kind_names_.begin(), kind_names_.end(), names[i]);
+			if (it == kind_names_.end())
+			{
+				std::cerr << "Fatal error: unknown type " << names[i] << ". Available: idt | idt-vt | jsr | lbv | bsf | ctp | oc" << std::endl;
+				return -1;
+			}
+			kinds.push_back(static_cast<Kind>(it - kind_names_.begin()));
+		}
+	}
+
+	const std::vector<std::string> species = ReadSpeciesFromKinetics(vm["kinetics"].as<std::string>());
+	if (species.size() < settings.species)
+	{
+		std::cerr << "Fatal error: the kinetic mechanism includes only " << species.size() << " species" << std::endl;
+		return -1;
+	}
+
+	const boost::filesystem::path output_folder = vm["output"].as<std::string>();
+	boost::filesystem::create_directories(output_folder);
+
+	const unsigned int seed = vm["seed"].as<unsigned int>();
+	Generator generator(species, settings, seed);
+
+	std::mt19937 random(seed);
+	std::ofstream fManifest((output_folder / "corpus.txt").string(), std::ios::out);
+	fManifest << std::left << std::setw(32) << "File" << std::setw(10) << "Type" << "Error" << std::endl;
+
+	const unsigned int n_files = vm["files"].as<unsigned int>();
+	unsigned int n_errors = 0;
+	for (unsigned int i = 0; i < n_files; i++)
+	{
+		const Kind kind = kinds[i % kinds.size()];
+
+		Error error = Error::NONE;
+		if (std::uniform_real_distribution<double>(0., 1.)(random) < settings.errors)
+		{
+			error = static_cast<Error>(1 + std::uniform_int_distribution<int>(0, static_cast<int>(error_names_.size()) - 2)(random));
+			n_errors++;
+		}
+
+		std::ostringstream name;
+		name << "synthetic_" << std::setw(6) << std::setfill('0') << i + 1 << "_" << kind_names_[static_cast<int>(kind)] << ".xml";
+
+		std::ofstream fOut((output_folder / name.str()).string(), std::ios::out | std::ios::binary);
+		fOut << generator.Generate(kind, error, i + 1);
+		fOut.close();
+
+		fManifest << std::setw(32) << name.str() << std::setw(10) << kind_names_[static_cast<int>(kind)] << error_names_[static_cast<int>(error)] << std::endl;
+	}
+	fManifest.close();
+
+	std::cout << "Generated " << n_files << " files (" << n_errors << " with injected errors) in " << output_folder.string() << std::endl;
+
+	return 0;
+}
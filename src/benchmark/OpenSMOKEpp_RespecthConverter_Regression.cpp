@@ -0,0 +1,409 @@
+/*-----------------------------------------------------------------------*\
+|    ___                   ____  __  __  ___  _  _______                  |
+|   / _ \ _ __   ___ _ __ / ___||  \/  |/ _ \| |/ / ____| _     _         |
+|  | | | | '_ \ / _ \ '_ \\___ \| |\/| | | | | ' /|  _| _| |_ _| |_       |
+|  | |_| | |_) |  __/ | | |___) | |  | | |_| | . \| |__|_   _|_   _|      |
+|   \___/| .__/ \___|_| |_|____/|_|  |_|\___/|_|\_\_____||_|   |_|        |
+|        |_|                                                              |
+|                                                                         |
+|   Author: Alberto Cuoci <alberto.cuoci@polimi.it>                       |
+|   CRECK Modeling Group <http://creckmodeling.chem.polimi.it>            |
+|   Department of Chemistry, Materials and Chemical Engineering           |
+|   Politecnico di Milano                                                 |
+|   P.zza Leonardo da Vinci 32, 20133 Milano                              |
+|                                                                         |
+|-------------------------------------------------------------------------|
+|                                                                         |
+|   This file is part of OpenSMOKE++ framework.                           |
+|                                                                         |
+|	License                                                               |
+|                                                                         |
+|   Copyright(C) 2020  Alberto Cuoci                                      |
+|   OpenSMOKE++ is free software: you can redistribute it and/or modify   |
+|   it under the terms of the GNU General Public License as published by  |
+|   the Free Software Foundation, either version 3 of the License, or     |
+|   (at your option) any later version.                                   |
+|                                                                         |
+|   OpenSMOKE++ is distributed in the hope that it will be useful,        |
+|   but WITHOUT ANY WARRANTY; without even the implied warranty of        |
+|   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         |
+|   GNU General Public License for more details.                          |
+|                                                                         |
+|   You should have received a copy of the GNU General Public License     |
+|   along with OpenSMOKE++. If not, see <http://www.gnu.org/licenses/>.   |
+|                                                                         |
+\*-----------------------------------------------------------------------*/
+
+
+// End-to-end regression harness. The converter is run on a fixed reference corpus,
+// once for each case (the default options, and a case enabling the optional keywords
+// of the main dictionary and of the command line), and every file it produces is
+// compared byte by byte with the golden outputs of the case. The run fails if any
+// output differs from the golden one.
+// The throughput (files per second) and the peak resident set size of the default case
+// are always reported, but compared with the stored baseline only with --throughput:
+// the baseline is machine specific and the corpus is small, so the gate is meant for
+// runs on the machine which produced the baseline.
+// With --update the golden outputs and the baseline are replaced by the current ones.
+//
+// The converter runs in a scratch folder with relative output paths, so that the
+// produced files do not depend on the machine where the harness is executed.
+
+#include <string>
+#include <vector>
+#include <set>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+namespace
+{
+	struct RunResult
+	{
+		bool success;
+		double seconds;
+		long peak_rss_kb;
+	};
+
+	// Options of the main dictionary and command line arguments of the converter
+	struct Case
+	{
+		std::string name;
+		std::vector<std::string> keywords;
+		std::vector<std::string> arguments;
+	};
+
+	std::vector<Case> ListOfCases()
+	{
+		std::vector<Case> cases(2);
+
+		cases[0].name = "default";
+
+		cases[1].name = "options";
+		cases[1].keywords = {	"@ProfileDecimationTolerance 0.01", "@ShareProfiles true",
+								"@EndTimePolicy buckets", "@ResidenceTimeFactor 5", "@MergeResidenceTimes true",
+								"@SampleMeasuredTimes true", "@RestrictOutputSpecies true", "@ReorderPoints true",
+								"@SeedFlameSpeed true", "@PlanFlameGrid true", "@Fidelity screening",
+								"@AutomaticTolerances true", "@MaxPointsPerDictionary 3",
+								"@DeduplicatePoints true", "@CoalesceExperiments true" };
+		cases[1].arguments = { "--manifest", "output/manifest.txt", "--sort-by-cost", "--bundles", "2", "--ninja", "2" };
+
+		return cases;
+	}
+
+	// Runs the converter in the working folder (stdin from /dev/null, since the error
+	// messages of the converter wait for the enter key)
+	RunResult RunConverter(const boost::filesystem::path& converter, const std::vector<std::string>& arguments, const boost::filesystem::path& working_folder, const boost::filesystem::path& log_file)
+	{
+		RunResult result = { false, 0., 0 };
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			if (chdir(working_folder.c_str()) != 0)
+				_exit(127);
+
+			const int fd_in = open("/dev/null", O_RDONLY);
+			const int fd_out = open(log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (fd_in < 0 || fd_out < 0)
+				_exit(127);
+			dup2(fd_in, STDIN_FILENO);
+			dup2(fd_out, STDOUT_FILENO);
+			dup2(fd_out, STDERR_FILENO);
+
+			std::vector<char*> argv;
+			argv.push_back(const_cast<char*>(converter.c_str()));
+			argv.push_back(const_cast<char*>("--input"));
+			argv.push_back(const_cast<char*>("input.dic"));
+			for (unsigned int i = 0; i < arguments.size(); i++)
+				argv.push_back(const_cast<char*>(arguments[i].c_str()));
+			argv.push_back(nullptr);
+
+			execv(converter.c_str(), argv.data());
+			_exit(127);
+		}
+		else if (pid < 0)
+			return result;
+
+		int status = 0;
+		struct rusage usage;
+		if (wait4(pid, &status, 0, &usage) < 0)
+			return result;
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.peak_rss_kb = usage.ru_maxrss;
+		result.success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+		return result;
+	}
+
+	// Relative names of the files in a folder (sorted)
+	std::vector<std::string> ListOfFiles(const boost::filesystem::path& folder)
+	{
+		std::vector<std::string> list;
+		if (boost::filesystem::exists(folder))
+		{
+			for (boost::filesystem::recursive_directory_iterator it(folder), end; it != end; ++it)
+				if (boost::filesystem::is_regular_file(it->path()))
+					list.push_back(it->path().lexically_relative(folder).generic_string());
+		}
+		std::sort(list.begin(), list.end());
+		return list;
+	}
+
+	std::string ReadFile(const boost::filesystem::path& file_name)
+	{
+		std::ifstream fInput(file_name.string(), std::ios::in | std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(fInput), std::istreambuf_iterator<char>());
+	}
+
+	// Line number of the first difference
+	unsigned int FirstDifferentLine(const std::string& a, const std::string& b)
+	{
+		const std::pair<std::string::const_iterator, std::string::const_iterator> it =
+			(a.size() <= b.size()) ? std::mismatch(a.begin(), a.end(), b.begin()) : std::mismatch(b.begin(), b.end(), a.begin());
+		const std::string& shortest = (a.size() <= b.size()) ? a : b;
+		return 1 + static_cast<unsigned int>(std::count(shortest.begin(), it.first, '\n'));
+	}
+
+	bool ReadBaseline(const boost::filesystem::path& file_name, double& files_per_second, long& peak_rss_kb)
+	{
+		std::ifstream fInput(file_name.string(), std::ios::in);
+		if (!fInput.is_open())
+			return false;
+
+		std::string key;
+		while (fInput >> key)
+		{
+			if (key == "files-per-second")		fInput >> files_per_second;
+			else if (key == "peak-rss-kb")		fInput >> peak_rss_kb;
+		}
+		return true;
+	}
+
+	void WriteBaseline(const boost::filesystem::path& file_name, const double files_per_second, const long peak_rss_kb)
+	{
+		std::ofstream fOut(file_name.string(), std::ios::out);
+		fOut << "files-per-second " << std::fixed << std::setprecision(3) << files_per_second << std::endl;
+		fOut << "peak-rss-kb      " << peak_rss_kb << std::endl;
+	}
+
+	// Number of missing, unexpected and different files with respect to the golden outputs
+	bool CompareWithGolden(const boost::filesystem::path& output, const boost::filesystem::path& golden)
+	{
+		const std::vector<std::string> produced = ListOfFiles(output);
+		const std::vector<std::string> expected = ListOfFiles(golden);
+
+		std::vector<std::string> missing;
+		std::vector<std::string> unexpected;
+		std::set_difference(expected.begin(), expected.end(), produced.begin(), produced.end(), std::back_inserter(missing));
+		std::set_difference(produced.begin(), produced.end(), expected.begin(), expected.end(), std::back_inserter(unexpected));
+
+		for (unsigned int i = 0; i < missing.size(); i++)
+			std::cout << "   missing:    " << missing[i] << std::endl;
+		for (unsigned int i = 0; i < unexpected.size(); i++)
+			std::cout << "   unexpected: " << unexpected[i] << std::endl;
+
+		unsigned int n_different = 0;
+		for (unsigned int i = 0; i < produced.size(); i++)
+		{
+			if (std::binary_search(expected.begin(), expected.end(), produced[i]) == false)
+				continue;
+
+			const std::string a = ReadFile(output / produced[i]);
+			const std::string b = ReadFile(golden / produced[i]);
+			if (a != b)
+			{
+				std::cout << "   different:  " << produced[i] << " (line " << FirstDifferentLine(a, b) << ")" << std::endl;
+				n_different++;
+			}
+		}
+
+		std::cout << "Golden outputs:    " << expected.size() << " files, " << missing.size() << " missing, ";
+		std::cout << unexpected.size() << " unexpected, " << n_different << " different" << std::endl;
+
+		return expected.size() != 0 && missing.size() == 0 && unexpected.size() == 0 && n_different == 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	namespace po = boost::program_options;
+	po::options_description description("Options for the OpenSMOKEpp_RespecthConverter_Regression");
+	description.add_options()
+		("help", "print help messages")
+		("converter", po::value<std::string>(), "converter executable")
+		("corpus", po::value<std::string>(), "folder containing the reference corpus (XML files)")
+		("kinetics", po::value<std::string>(), "kinetics folder including the species of the reference corpus")
+		("golden", po::value<std::string>(), "folder containing the golden outputs (one subfolder for each case)")
+		("baseline", po::value<std::string>(), "file containing the baseline throughput (written if not available)")
+		("work", po::value<std::string>()->default_value("regression-work"), "scratch folder")
+		("throughput", "fail if the throughput drops below the baseline by more than the budget (the baseline is machine specific)")
+		("budget", po::value<double>()->default_value(0.10), "maximum relative drop of throughput with respect to the baseline (with --throughput)")
+		("repeat", po::value<unsigned int>()->default_value(3), "number of runs (the fastest one is retained)")
+		("update", "replace golden outputs and baseline with the current ones");
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, description), vm);
+		po::notify(vm);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl << std::endl;
+		std::cerr << description << std::endl;
+		return -1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+
+	if (vm.count("converter") == 0 || vm.count("corpus") == 0 || vm.count("kinetics") == 0 || vm.count("golden") == 0 || vm.count("baseline") == 0)
+	{
+		std::cerr << "Fatal error: --converter, --corpus, --kinetics, --golden and --baseline must be provided" << std::endl << std::endl;
+		std::cerr << description << std::endl;
+		return -1;
+	}
+
+	const boost::filesystem::path converter = boost::filesystem::absolute(vm["converter"].as<std::string>());
+	const boost::filesystem::path corpus = boost::filesystem::absolute(vm["corpus"].as<std::string>());
+	const boost::filesystem::path kinetics = boost::filesystem::absolute(vm["kinetics"].as<std::string>());
+	const boost::filesystem::path golden = boost::filesystem::absolute(vm["golden"].as<std::string>());
+	const boost::filesystem::path baseline = boost::filesystem::absolute(vm["baseline"].as<std::string>());
+	const boost::filesystem::path work = boost::filesystem::absolute(vm["work"].as<std::string>());
+	const double budget = vm["budget"].as<double>();
+	const unsigned int repeat = std::max(vm["repeat"].as<unsigned int>(), 1u);
+	const bool update = vm.count("update") != 0;
+	const bool check_throughput = vm.count("throughput") != 0;
+
+	unsigned int n_files = 0;
+	for (boost::filesystem::directory_iterator it(corpus), end; it != end; ++it)
+		if (it->path().extension() == ".xml")
+			n_files++;
+
+	bool success = true;
+	const std::vector<Case> cases = ListOfCases();
+	for (unsigned int c = 0; c < cases.size(); c++)
+	{
+		const boost::filesystem::path work_case = work / cases[c].name;
+		const boost::filesystem::path golden_case = golden / cases[c].name;
+
+		std::cout << std::endl << "Case: " << cases[c].name << std::endl;
+
+		// Main dictionary of the converter (kinetics and output folders written with relative paths)
+		boost::filesystem::remove_all(work_case);
+		boost::filesystem::create_directories(work_case);
+		{
+			std::ofstream fOut((work_case / "input.dic").string(), std::ios::out);
+			fOut << "Dictionary RespecthConverter" << std::endl;
+			fOut << "{" << std::endl;
+			fOut << "        @KineticsFolder          " << kinetics.string() << ";" << std::endl;
+			fOut << "        @KineticsFolderRemote    kinetics;" << std::endl;
+			fOut << "        @InputFolder             " << corpus.string() << ";" << std::endl;
+			fOut << "        @OutputFolderRemote      output;" << std::endl;
+			for (unsigned int i = 0; i < cases[c].keywords.size(); i++)
+				fOut << "        " << cases[c].keywords[i] << ";" << std::endl;
+			fOut << "}" << std::endl;
+		}
+
+		// Conversion (the default case is repeated and the fastest run is retained)
+		const boost::filesystem::path output = work_case / "output";
+		const unsigned int n_runs = (c == 0) ? repeat : 1;
+		RunResult best = { false, 0., 0 };
+		for (unsigned int k = 0; k < n_runs; k++)
+		{
+			boost::filesystem::remove_all(output);
+			boost::filesystem::create_directories(output);
+
+			const RunResult result = RunConverter(converter, cases[c].arguments, work_case, work_case / "converter.log");
+			if (result.success == false)
+			{
+				std::cout << "FAILED: the conversion of the reference corpus failed (see " << (work_case / "converter.log").string() << ")" << std::endl;
+				return 1;
+			}
+
+			if (k == 0 || result.seconds < best.seconds)
+				best = result;
+			best.peak_rss_kb = std::max(best.peak_rss_kb, result.peak_rss_kb);
+		}
+
+		// Replace golden outputs
+		if (update == true)
+		{
+			boost::filesystem::remove_all(golden_case);
+			boost::filesystem::create_directories(golden_case);
+
+			const std::vector<std::string> produced = ListOfFiles(output);
+			for (unsigned int i = 0; i < produced.size(); i++)
+			{
+				boost::filesystem::create_directories((golden_case / produced[i]).parent_path());
+				boost::filesystem::copy_file(output / produced[i], golden_case / produced[i]);
+			}
+			std::cout << "Golden outputs updated: " << produced.size() << " files" << std::endl;
+		}
+
+		// Comparison with golden outputs
+		else if (CompareWithGolden(output, golden_case) == false)
+		{
+			std::cout << "FAILED: the outputs differ from the golden ones" << std::endl;
+			success = false;
+		}
+
+		if (c != 0)
+			continue;
+
+		// Throughput of the default case
+		const double files_per_second = n_files / best.seconds;
+
+		std::cout << "Reference corpus:  " << n_files << " files" << std::endl;
+		std::cout << "Conversion time:   " << std::fixed << std::setprecision(3) << best.seconds << " s (best of " << repeat << ")" << std::endl;
+		std::cout << "Throughput:        " << std::fixed << std::setprecision(1) << files_per_second << " files/s" << std::endl;
+		std::cout << "Peak RSS:          " << best.peak_rss_kb << " kB" << std::endl;
+
+		double baseline_files_per_second = 0.;
+		long baseline_peak_rss_kb = 0;
+		if (update == true || ReadBaseline(baseline, baseline_files_per_second, baseline_peak_rss_kb) == false)
+		{
+			WriteBaseline(baseline, files_per_second, best.peak_rss_kb);
+			std::cout << "Baseline written in " << baseline.string() << std::endl;
+		}
+		else
+		{
+			const double ratio = files_per_second / baseline_files_per_second;
+			std::cout << "Baseline:          " << std::fixed << std::setprecision(1) << baseline_files_per_second << " files/s, ";
+			std::cout << baseline_peak_rss_kb << " kB (throughput " << std::setprecision(1) << (ratio - 1.) * 100. << "%)" << std::endl;
+
+			if (check_throughput == true && ratio < 1. - budget)
+			{
+				std::cout << "FAILED: the throughput dropped by more than " << budget * 100. << "% with respect to the baseline" << std::endl;
+				success = false;
+			}
+		}
+	}
+
+	if (update == true)
+		return 0;
+
+	std::cout << std::endl;
+	if (success == true)
+		std::cout << "PASSED" << std::endl;
+
+	return (success == true) ? 0 : 1;
+}